@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "archive/brotli.h"
+#include "archive/zlib.h"
+#include "archive/zstd.h"
+
+#include "archive/corpus_app_js.h"
+#include "archive/corpus_page_html.h"
+#include "archive/corpus_site_css.h"
+
+#include "etest/alloc_counter.h"
+#include "etest/etest2.h"
+
+#include <brotli/encode.h>
+#include <nanobench.h>
+#include <zconf.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Payload {
+    std::string_view name;
+    std::span<unsigned char const> data;
+};
+
+// The payload sizes are roughly a small inline resource, a typical page or
+// stylesheet, and a large bundle. Larger sizes repeat the corpus file.
+constexpr auto kSizes = std::to_array<std::size_t>({1024, 64 * 1024, 1024 * 1024});
+
+std::vector<Payload> corpus() {
+    return {
+            {"html", {archive_corpus_page_html, archive_corpus_page_html_len}},
+            {"css", {archive_corpus_site_css, archive_corpus_site_css_len}},
+            {"js", {archive_corpus_app_js, archive_corpus_app_js_len}},
+    };
+}
+
+std::vector<std::byte> make_input(std::span<unsigned char const> data, std::size_t size) {
+    std::vector<std::byte> out;
+    out.reserve(size);
+    while (out.size() < size) {
+        auto const n = std::min(size - out.size(), data.size());
+        auto const *begin = reinterpret_cast<std::byte const *>(data.data());
+        out.insert(out.end(), begin, begin + n);
+    }
+    return out;
+}
+
+std::vector<std::byte> zlib_encode(std::span<std::byte const> input, archive::ZlibMode mode) {
+    z_stream s{};
+    int const window_bits = mode == archive::ZlibMode::Gzip ? 15 + 16 : 15;
+    if (deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        std::abort();
+    }
+
+    std::vector<std::byte> out(deflateBound(&s, static_cast<uLong>(input.size())));
+    s.next_in = reinterpret_cast<Bytef const *>(input.data());
+    s.avail_in = static_cast<uInt>(input.size());
+    s.next_out = reinterpret_cast<Bytef *>(out.data());
+    s.avail_out = static_cast<uInt>(out.size());
+    if (deflate(&s, Z_FINISH) != Z_STREAM_END) {
+        std::abort();
+    }
+
+    out.resize(s.total_out);
+    deflateEnd(&s);
+    return out;
+}
+
+std::vector<std::byte> zstd_encode(std::span<std::byte const> input) {
+    std::vector<std::byte> out(ZSTD_compressBound(input.size()));
+    auto const size = ZSTD_compress(out.data(), out.size(), input.data(), input.size(), ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(size) != 0) {
+        std::abort();
+    }
+
+    out.resize(size);
+    return out;
+}
+
+std::vector<std::byte> brotli_encode(std::span<std::byte const> input) {
+    auto size = BrotliEncoderMaxCompressedSize(input.size());
+    std::vector<std::byte> out(size);
+    if (BrotliEncoderCompress(BROTLI_DEFAULT_QUALITY,
+                BROTLI_DEFAULT_WINDOW,
+                BROTLI_MODE_TEXT,
+                input.size(),
+                reinterpret_cast<std::uint8_t const *>(input.data()),
+                &size,
+                reinterpret_cast<std::uint8_t *>(out.data()))
+            == BROTLI_FALSE) {
+        std::abort();
+    }
+
+    out.resize(size);
+    return out;
+}
+
+using Encoder = std::function<std::vector<std::byte>(std::span<std::byte const>)>;
+using Decoder = std::function<std::size_t(std::span<std::byte const>)>;
+
+void run_decode_bench(etest::IActions &a, std::string const &title, Encoder const &encode, Decoder const &decode) {
+    ankerl::nanobench::Bench bench;
+    bench.title(title).unit("byte");
+
+    for (auto const &payload : corpus()) {
+        for (auto size : kSizes) {
+            auto const input = make_input(payload.data, size);
+            auto const encoded = encode(input);
+
+            auto const allocations_before = etest::allocation_count();
+            a.require_eq(decode(encoded), input.size());
+            auto const allocations = etest::allocation_count() - allocations_before;
+
+            auto const name = std::format("{}, {} KiB, ratio {:.2f}, {} allocs/call",
+                    payload.name,
+                    size / 1024,
+                    static_cast<double>(input.size()) / static_cast<double>(encoded.size()),
+                    allocations);
+            bench.batch(input.size()).run(name, [&] {
+                ankerl::nanobench::doNotOptimizeAway(decode(encoded)); //
+            });
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("decode: zlib", [](etest::IActions &a) {
+        run_decode_bench(
+                a,
+                "decode: zlib",
+                [](auto input) { return zlib_encode(input, archive::ZlibMode::Zlib); },
+                [](auto input) { return archive::zlib_decode(input, archive::ZlibMode::Zlib).value().size(); });
+    });
+
+    s.add_test("decode: gzip", [](etest::IActions &a) {
+        run_decode_bench(
+                a,
+                "decode: gzip",
+                [](auto input) { return zlib_encode(input, archive::ZlibMode::Gzip); },
+                [](auto input) { return archive::zlib_decode(input, archive::ZlibMode::Gzip).value().size(); });
+    });
+
+    s.add_test("decode: zstd", [](etest::IActions &a) {
+        run_decode_bench(a, "decode: zstd", zstd_encode, [](auto input) {
+            return archive::zstd_decode(input).value().size(); //
+        });
+    });
+
+    s.add_test("decode: brotli", [](etest::IActions &a) {
+        run_decode_bench(a, "decode: brotli", brotli_encode, [](auto input) {
+            return archive::brotli_decode(input).value().size(); //
+        });
+    });
+
+    return s.run();
+}
@@ -46,6 +46,15 @@ tl::expected<std::vector<std::byte>, BrotliError> BrotliDecoder::decode(std::spa
         return tl::unexpected{BrotliError::DecoderState};
     }
 
+    if (!dictionary_.empty()
+            && BrotliDecoderAttachDictionary(br_state.get(),
+                       BROTLI_SHARED_DICTIONARY_RAW,
+                       dictionary_.size(),
+                       reinterpret_cast<std::uint8_t const *>(dictionary_.data()))
+                    == BROTLI_FALSE) {
+        return tl::unexpected{BrotliError::BrotliInternalError};
+    }
+
     std::size_t constexpr kChunkSize = 131072; // Matches the zstd chunk size
 
     std::vector<std::byte> out;
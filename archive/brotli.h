@@ -32,8 +32,14 @@ public:
 
     void set_max_output_length(std::size_t length) { max_output_length_ = length; }
 
+    // Decode using a raw dictionary, e.g. one negotiated through Compression
+    // Dictionary Transport. The dictionary is not copied, so it must outlive
+    // any decode calls.
+    void set_dictionary(std::span<std::byte const> dictionary) { dictionary_ = dictionary; }
+
 private:
     std::size_t max_output_length_ = std::size_t{1024} * 1024 * 1024;
+    std::span<std::byte const> dictionary_;
 };
 
 inline tl::expected<std::vector<std::byte>, BrotliError> brotli_decode(std::span<std::byte const> input) {
@@ -114,6 +114,32 @@ int main() {
         a.expect(ret->empty());
     });
 
+    s.add_test("raw dictionary", [](etest::IActions &a) {
+        // Hand-written, as a single command copying all of the dictionary,
+        // which is treated as if it came right before the output.
+        constexpr auto kCompress =
+                std::to_array<std::uint8_t>({0xa2, 0x04, 0x00, 0x00, 0x44, 0x58, 0x18, 0x13, 0x16, 0x24});
+        constexpr auto kDictionary = std::string_view{"This is a test of a brotli dictionary."};
+
+        a.expect_eq(brotli_decode(as_bytes(kCompress)), tl::unexpected{BrotliError::InputCorrupt});
+
+        BrotliDecoder decoder;
+        decoder.set_dictionary({reinterpret_cast<std::byte const *>(kDictionary.data()), kDictionary.size()});
+        auto ret = decoder.decode(as_bytes(kCompress));
+        a.require(ret.has_value());
+        a.expect_eq(std::string_view{reinterpret_cast<char const *>(ret->data()), ret->size()}, kDictionary);
+    });
+
+    s.add_test("wrong raw dictionary", [](etest::IActions &a) {
+        constexpr auto kCompress =
+                std::to_array<std::uint8_t>({0xa2, 0x04, 0x00, 0x00, 0x44, 0x58, 0x18, 0x13, 0x16, 0x24});
+        constexpr auto kDictionary = std::string_view{"Not the dictionary."};
+
+        BrotliDecoder decoder;
+        decoder.set_dictionary({reinterpret_cast<std::byte const *>(kDictionary.data()), kDictionary.size()});
+        a.expect_eq(decoder.decode(as_bytes(kCompress)), tl::unexpected{BrotliError::InputCorrupt});
+    });
+
     s.add_test("all error codes can be printed", [](etest::IActions &a) {
         static constexpr auto kFirstError = BrotliError::BrotliInternalError;
         static constexpr auto kLastError = BrotliError::MaximumOutputLengthExceeded;
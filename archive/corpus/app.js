@@ -0,0 +1,251 @@
+(function () {
+  "use strict";
+
+  var STORAGE_KEY = "dx:prefs";
+  var ANALYTICS_ENDPOINT = "/api/v2/events";
+  var LAZY_ROOT_MARGIN = "200px 0px";
+
+  function $(selector, root) {
+    return (root || document).querySelector(selector);
+  }
+
+  function $$(selector, root) {
+    return Array.prototype.slice.call((root || document).querySelectorAll(selector));
+  }
+
+  function debounce(fn, wait) {
+    var timeout = null;
+    return function () {
+      var context = this;
+      var args = arguments;
+      clearTimeout(timeout);
+      timeout = setTimeout(function () {
+        timeout = null;
+        fn.apply(context, args);
+      }, wait);
+    };
+  }
+
+  function readPrefs() {
+    try {
+      var raw = window.localStorage.getItem(STORAGE_KEY);
+      return raw ? JSON.parse(raw) : {};
+    } catch (e) {
+      return {};
+    }
+  }
+
+  function writePrefs(prefs) {
+    try {
+      window.localStorage.setItem(STORAGE_KEY, JSON.stringify(prefs));
+    } catch (e) {
+      // Private browsing or quota exceeded; preferences are best-effort.
+    }
+  }
+
+  var Analytics = {
+    queue: [],
+    flushing: false,
+
+    track: function (name, data) {
+      this.queue.push({
+        name: name,
+        data: data || {},
+        path: window.location.pathname,
+        ts: Date.now()
+      });
+      this.scheduleFlush();
+    },
+
+    scheduleFlush: debounce(function () {
+      Analytics.flush();
+    }, 2000),
+
+    flush: function () {
+      if (this.flushing || this.queue.length === 0) {
+        return;
+      }
+
+      var batch = this.queue.splice(0, 20);
+      var body = JSON.stringify({ events: batch });
+      this.flushing = true;
+
+      if (navigator.sendBeacon && navigator.sendBeacon(ANALYTICS_ENDPOINT, body)) {
+        this.flushing = false;
+        return;
+      }
+
+      fetch(ANALYTICS_ENDPOINT, {
+        method: "POST",
+        headers: { "Content-Type": "application/json" },
+        body: body,
+        keepalive: true
+      }).catch(function () {
+        Analytics.queue = batch.concat(Analytics.queue);
+      }).then(function () {
+        Analytics.flushing = false;
+      });
+    }
+  };
+
+  function initLazyImages() {
+    var images = $$("img[loading='lazy'][data-src]");
+    if (!("IntersectionObserver" in window)) {
+      images.forEach(function (img) {
+        img.src = img.getAttribute("data-src");
+      });
+      return;
+    }
+
+    var observer = new IntersectionObserver(function (entries) {
+      entries.forEach(function (entry) {
+        if (!entry.isIntersecting) {
+          return;
+        }
+        var img = entry.target;
+        img.src = img.getAttribute("data-src");
+        img.removeAttribute("data-src");
+        observer.unobserve(img);
+      });
+    }, { rootMargin: LAZY_ROOT_MARGIN });
+
+    images.forEach(function (img) {
+      observer.observe(img);
+    });
+  }
+
+  function initShare() {
+    $$(".share").forEach(function (share) {
+      var url = share.getAttribute("data-share-url") || window.location.href;
+      var copy = $("[data-action='copy-link']", share);
+      if (!copy) {
+        return;
+      }
+
+      copy.addEventListener("click", function () {
+        var done = function () {
+          copy.textContent = "Copied!";
+          setTimeout(function () {
+            copy.textContent = "Copy link";
+          }, 1500);
+          Analytics.track("share", { method: "copy" });
+        };
+
+        if (navigator.clipboard && navigator.clipboard.writeText) {
+          navigator.clipboard.writeText(url).then(done, function () {});
+        } else {
+          var input = document.createElement("input");
+          input.value = url;
+          document.body.appendChild(input);
+          input.select();
+          document.execCommand("copy");
+          document.body.removeChild(input);
+          done();
+        }
+      });
+    });
+  }
+
+  function initNav() {
+    var path = window.location.pathname;
+    $$(".site-nav__link").forEach(function (link) {
+      var href = link.getAttribute("href");
+      if (href !== "/" && path.indexOf(href) === 0) {
+        link.setAttribute("aria-current", "page");
+      }
+    });
+  }
+
+  function initSearch() {
+    var input = $("#q");
+    if (!input) {
+      return;
+    }
+
+    var list = document.createElement("ul");
+    list.className = "site-search__suggestions";
+    list.setAttribute("role", "listbox");
+    input.parentNode.appendChild(list);
+
+    var suggest = debounce(function () {
+      var query = input.value.trim();
+      if (query.length < 3) {
+        list.innerHTML = "";
+        return;
+      }
+
+      fetch("/api/v2/suggest?q=" + encodeURIComponent(query))
+        .then(function (res) {
+          return res.ok ? res.json() : { items: [] };
+        })
+        .then(function (json) {
+          list.innerHTML = json.items.slice(0, 8).map(function (item) {
+            return "<li role=\"option\"><a href=\"" + item.url + "\">" + item.title + "</a></li>";
+          }).join("");
+        })
+        .catch(function () {
+          list.innerHTML = "";
+        });
+    }, 250);
+
+    input.addEventListener("input", suggest);
+  }
+
+  function initReadingProgress() {
+    var article = $(".article__body");
+    if (!article) {
+      return;
+    }
+
+    var bar = document.createElement("div");
+    bar.className = "reading-progress";
+    document.body.appendChild(bar);
+
+    var milestones = { 25: false, 50: false, 75: false, 100: false };
+    var update = function () {
+      var rect = article.getBoundingClientRect();
+      var total = rect.height - window.innerHeight;
+      var progress = total > 0 ? Math.min(100, Math.max(0, (-rect.top / total) * 100)) : 100;
+      bar.style.width = progress + "%";
+
+      Object.keys(milestones).forEach(function (key) {
+        if (!milestones[key] && progress >= Number(key)) {
+          milestones[key] = true;
+          Analytics.track("scroll_depth", { percent: Number(key) });
+        }
+      });
+    };
+
+    window.addEventListener("scroll", debounce(update, 50), { passive: true });
+    update();
+  }
+
+  function applyTheme() {
+    var prefs = readPrefs();
+    if (prefs.theme === "dark" || prefs.theme === "light") {
+      document.body.classList.remove("theme-light", "theme-dark");
+      document.body.classList.add("theme-" + prefs.theme);
+    }
+  }
+
+  function init() {
+    applyTheme();
+    initNav();
+    initLazyImages();
+    initShare();
+    initSearch();
+    initReadingProgress();
+    Analytics.track("pageview", { referrer: document.referrer });
+    window.addEventListener("pagehide", function () {
+      Analytics.flush();
+    });
+  }
+
+  window.DX = { prefs: { read: readPrefs, write: writePrefs }, track: Analytics.track.bind(Analytics) };
+
+  if (document.readyState === "loading") {
+    document.addEventListener("DOMContentLoaded", init);
+  } else {
+    init();
+  }
+})();
@@ -15,6 +15,13 @@
 #include <vector>
 
 namespace archive {
+namespace {
+
+bool starts_with_gzip_member(Bytef const *data, uInt size) {
+    return size >= 2 && data[0] == 0x1f && data[1] == 0x8b;
+}
+
+} // namespace
 
 tl::expected<std::vector<std::byte>, ZlibError> zlib_decode(
         std::span<std::byte const> data, ZlibMode mode, std::size_t max_output_length) {
@@ -50,7 +57,7 @@ tl::expected<std::vector<std::byte>, ZlibError> zlib_decode(
     std::string buf{};
     constexpr auto kZlibInflateChunkSize = std::size_t{64} * 1024; // Chosen by a fair dice roll.
     buf.resize(kZlibInflateChunkSize);
-    do {
+    while (true) {
         s.next_out = reinterpret_cast<Bytef *>(buf.data());
         s.avail_out = static_cast<uInt>(buf.size());
         int ret = inflate(&s, Z_NO_FLUSH);
@@ -71,7 +78,24 @@ tl::expected<std::vector<std::byte>, ZlibError> zlib_decode(
 
         auto const *buf_ptr = reinterpret_cast<std::byte const *>(buf.data());
         out.insert(out.end(), buf_ptr, buf_ptr + inflated_bytes);
-    } while (s.avail_out == 0);
+
+        // A gzip stream may consist of several concatenated members, see
+        // https://datatracker.ietf.org/doc/html/rfc1952#section-2.2. Each
+        // member's start is only known once the previous one has been
+        // inflated, so these are decoded one after another.
+        if (ret == Z_STREAM_END) {
+            if (mode == ZlibMode::Gzip && starts_with_gzip_member(s.next_in, s.avail_in)) {
+                inflateReset(&s);
+                continue;
+            }
+
+            break;
+        }
+
+        if (s.avail_out != 0) {
+            break;
+        }
+    }
 
     inflateEnd(&s);
     return out;
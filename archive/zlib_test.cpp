@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <span>
+#include <string>
 #include <string_view>
 
 using namespace archive;
@@ -58,5 +59,21 @@ int main() {
         a.expect_eq(err.error().message, "Output too large");
     });
 
+    s.add_test("gzip, multiple members", [](etest::IActions &a) {
+        auto const input = std::string{kGzippedCss} + std::string{kGzippedCss};
+        auto const expected = std::string{kExpected} + std::string{kExpected};
+
+        auto res = zlib_decode(as_bytes(input), ZlibMode::Gzip);
+        a.expect(std::ranges::equal(res.value(), as_bytes(expected)));
+
+        auto err = zlib_decode(as_bytes(input), ZlibMode::Gzip, expected.size() - 1);
+        a.expect(!err.has_value());
+        a.expect_eq(err.error().message, "Output too large");
+
+        // Trailing data that isn't a gzip member is ignored.
+        res = zlib_decode(as_bytes(std::string{kGzippedCss} + "garbage"), ZlibMode::Gzip);
+        a.expect(std::ranges::equal(res.value(), as_bytes(kExpected)));
+    });
+
     return s.run();
 }
@@ -6,14 +6,21 @@
 #include "archive/zstd.h"
 
 #include <tl/expected.hpp>
+
+// For ZSTD_DCtx_loadDictionary_advanced.
+#define ZSTD_STATIC_LINKING_ONLY
 #include <zstd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cstddef>
 #include <cstdlib>
+#include <future>
 #include <memory>
 #include <span>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #if CHAR_BIT != 8
@@ -39,33 +46,45 @@ std::string_view to_string(ZstdError err) {
     return "Unknown error";
 }
 
-tl::expected<std::vector<std::byte>, ZstdError> ZstdDecoder::decode(std::span<std::byte const> const input) const {
-    if (input.empty()) {
-        return tl::unexpected{ZstdError::InputEmpty};
-    }
+namespace {
+
+// Bytes decoded so far by every job working on the same input, so that no
+// job can use more than what's left of the output length limit.
+using OutputBudget = std::atomic<std::size_t>;
 
+tl::expected<std::vector<std::byte>, ZstdError> decode_stream(std::span<std::byte const> const input,
+        std::size_t const max_output_length,
+        std::span<std::byte const> const dictionary,
+        OutputBudget &total_output) {
     std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(ZSTD_createDCtx(), &ZSTD_freeDCtx);
 
     if (dctx == nullptr) {
         return tl::unexpected{ZstdError::DecompressionContext};
     }
 
+    // Loaded by reference and as raw content so that it's used as-is, even if
+    // it happens to look like a structured zstd dictionary.
+    if (!dictionary.empty()) {
+        std::size_t const ret = ZSTD_DCtx_loadDictionary_advanced(
+                dctx.get(), dictionary.data(), dictionary.size(), ZSTD_dlm_byRef, ZSTD_dct_rawContent);
+        if (ZSTD_isError(ret) != 0u) {
+            return tl::unexpected{ZstdError::ZstdInternalError};
+        }
+    }
+
     std::size_t const chunk_size = ZSTD_DStreamOutSize();
 
     std::vector<std::byte> out;
 
     ZSTD_inBuffer in_buf = {input.data(), input.size_bytes(), 0};
 
-    std::size_t count = 0;
     std::size_t last_ret = 0;
-    std::size_t last_pos = 0;
 
     while (in_buf.pos < in_buf.size) {
-        count++;
+        std::size_t const out_pos = out.size();
+        out.resize(out_pos + chunk_size);
 
-        out.resize(chunk_size * count);
-
-        ZSTD_outBuffer out_buf = {out.data() + (chunk_size * (count - 1)), chunk_size, 0};
+        ZSTD_outBuffer out_buf = {out.data() + out_pos, chunk_size, 0};
 
         std::size_t const ret = ZSTD_decompressStream(dctx.get(), &out_buf, &in_buf);
 
@@ -73,28 +92,113 @@ tl::expected<std::vector<std::byte>, ZstdError> ZstdDecoder::decode(std::span<st
             return tl::unexpected{ZstdError::ZstdInternalError};
         }
 
-        if (chunk_size * (count - 1) + out_buf.pos > max_output_length_) {
+        // Shrink buffer to match what we actually decoded. A call may produce
+        // less than a full chunk even if there's more input, e.g. at the end of
+        // a frame.
+        out.resize(out_pos + out_buf.pos);
+
+        // This also stops the other jobs once one of them has gone over.
+        if (total_output.fetch_add(out_buf.pos) + out_buf.pos > max_output_length) {
             return tl::unexpected{ZstdError::MaximumOutputLengthExceeded};
         }
 
         last_ret = ret;
-        last_pos = out_buf.pos;
     }
 
     if (last_ret != 0) {
         return tl::unexpected{ZstdError::DecodeEarlyTermination};
     }
 
+    return out;
+}
+
+// Splits the input at frame boundaries into contiguous runs of frames of
+// roughly input.size() / max_chunks bytes each. Returns an empty vector if the
+// frame boundaries can't be determined, e.g. because the input is truncated.
+std::vector<std::span<std::byte const>> split_at_frames(
+        std::span<std::byte const> const input, std::size_t const max_chunks) {
+    std::size_t const target_chunk_size = input.size() / max_chunks;
+    std::vector<std::span<std::byte const>> chunks;
+    std::size_t chunk_start = 0;
+    std::size_t pos = 0;
+
+    while (pos < input.size()) {
+        std::size_t const frame_size = ZSTD_findFrameCompressedSize(input.data() + pos, input.size() - pos);
+        if (ZSTD_isError(frame_size) != 0u) {
+            return {};
+        }
+
+        pos += frame_size;
+        if (pos - chunk_start >= target_chunk_size) {
+            chunks.push_back(input.subspan(chunk_start, pos - chunk_start));
+            chunk_start = pos;
+        }
+    }
+
+    if (chunk_start < pos) {
+        chunks.push_back(input.subspan(chunk_start));
+    }
+
+    return chunks;
+}
+
+} // namespace
+
+tl::expected<std::vector<std::byte>, ZstdError> ZstdDecoder::decode(std::span<std::byte const> const input) const {
+    if (input.empty()) {
+        return tl::unexpected{ZstdError::InputEmpty};
+    }
+
+    OutputBudget total_output{0};
+
+    // Each job gets at least parallel_decode_threshold_ bytes of input so that
+    // small responses don't pay for a thread per core.
+    std::size_t const threads = max_parallel_jobs_ != 0 ? max_parallel_jobs_ : std::thread::hardware_concurrency();
+    std::size_t const max_jobs = parallel_decode_threshold_ == 0
+            ? 1
+            : std::min<std::size_t>(threads, input.size() / parallel_decode_threshold_);
+    if (max_jobs <= 1) {
+        return decode_stream(input, max_output_length_, dictionary_, total_output);
+    }
+
+    // Frames are independent of each other, so if there are several of them,
+    // we can decode them in parallel and stitch the output together in order.
+    auto const chunks = split_at_frames(input, max_jobs);
+    if (chunks.size() <= 1) {
+        return decode_stream(input, max_output_length_, dictionary_, total_output);
+    }
+
+    // The first chunk is decoded on this thread while the others are decoded
+    // on their own.
+    std::vector<std::future<tl::expected<std::vector<std::byte>, ZstdError>>> jobs;
+    jobs.reserve(chunks.size() - 1);
+    for (auto chunk : std::span{chunks}.subspan(1)) {
+        jobs.push_back(std::async(std::launch::async, [this, chunk, &total_output] {
+            return decode_stream(chunk, max_output_length_, dictionary_, total_output);
+        }));
+    }
+
+    std::vector<tl::expected<std::vector<std::byte>, ZstdError>> decoded;
+    decoded.reserve(chunks.size());
+    decoded.push_back(decode_stream(chunks.front(), max_output_length_, dictionary_, total_output));
+    for (auto &job : jobs) {
+        decoded.push_back(job.get());
+    }
+
     std::size_t out_size = 0;
+    for (auto const &chunk : decoded) {
+        if (!chunk.has_value()) {
+            return tl::unexpected{chunk.error()};
+        }
 
-    if (count == 1) {
-        out_size = last_pos;
-    } else {
-        out_size = last_pos == 0 ? chunk_size * count : (chunk_size * count) - (chunk_size - last_pos);
+        out_size += chunk->size();
     }
 
-    // Shrink buffer to match what we actually decoded
-    out.resize(out_size);
+    std::vector<std::byte> out;
+    out.reserve(out_size);
+    for (auto const &chunk : decoded) {
+        out.insert(out.end(), chunk->begin(), chunk->end());
+    }
 
     return out;
 }
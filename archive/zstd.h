@@ -32,8 +32,25 @@ public:
 
     void set_max_output_length(std::size_t length) { max_output_length_ = length; }
 
+    // Inputs that consist of several independent frames are split at frame
+    // boundaries and decoded in parallel, with at least this many bytes of
+    // input per job. 0 disables parallel decoding.
+    void set_parallel_decode_threshold(std::size_t length) { parallel_decode_threshold_ = length; }
+
+    // The most jobs to split a parallel decode into. 0 uses one per hardware
+    // thread.
+    void set_max_parallel_jobs(std::size_t jobs) { max_parallel_jobs_ = jobs; }
+
+    // Decode using a raw content dictionary, e.g. one negotiated through
+    // Compression Dictionary Transport. The dictionary is not copied, so it
+    // must outlive any decode calls.
+    void set_dictionary(std::span<std::byte const> dictionary) { dictionary_ = dictionary; }
+
 private:
     std::size_t max_output_length_ = std::size_t{1024} * 1024 * 1024;
+    std::size_t parallel_decode_threshold_ = std::size_t{256} * 1024;
+    std::size_t max_parallel_jobs_ = 0;
+    std::span<std::byte const> dictionary_;
 };
 
 inline tl::expected<std::vector<std::byte>, ZstdError> zstd_decode(std::span<std::byte const> input) {
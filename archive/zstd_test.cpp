@@ -17,11 +17,39 @@
 #include <string_view>
 #include <vector>
 
+using namespace std::literals;
+
 namespace {
 std::span<std::byte const> as_bytes(std::span<std::uint8_t const> s) {
     return {reinterpret_cast<std::byte const *>(s.data()), s.size()};
 }
 
+// Wraps up to 255 bytes in a zstd frame containing a single raw block.
+std::vector<std::byte> make_raw_frame(std::string_view data) {
+    auto const block_header = static_cast<std::uint32_t>(data.size() << 3 | 1); // Last block, raw.
+    std::vector<std::byte> frame{
+            std::byte{0x28},
+            std::byte{0xb5},
+            std::byte{0x2f},
+            std::byte{0xfd},
+            std::byte{0x20}, // Single segment, 1-byte frame content size.
+            static_cast<std::byte>(data.size()),
+            static_cast<std::byte>(block_header & 0xff),
+            static_cast<std::byte>((block_header >> 8) & 0xff),
+            static_cast<std::byte>((block_header >> 16) & 0xff),
+    };
+
+    for (char c : data) {
+        frame.push_back(static_cast<std::byte>(c));
+    }
+
+    return frame;
+}
+
+// A skippable frame with 4 bytes of user data.
+constexpr auto kSkippableFrame = std::to_array<std::uint8_t>(
+        {0x50, 0x2a, 0x4d, 0x18, 0x04, 0x00, 0x00, 0x00, 0xde, 0xad, 0xbe, 0xef});
+
 // "This is a test string\n"
 constexpr auto kSuccessTestString = std::to_array<std::uint8_t>({0x28,
         0xb5,
@@ -281,6 +309,84 @@ int main() {
         a.expect_eq(ret.error(), ZstdError::DecodeEarlyTermination);
     });
 
+    s.add_test("multiple frames", [](etest::IActions &a) {
+        std::vector<std::byte> input;
+        std::string expected;
+        for (int i = 0; i < 64; ++i) {
+            auto const data = std::string(static_cast<std::size_t>(i) + 1, static_cast<char>('a' + (i % 26)));
+            auto const frame = make_raw_frame(data);
+            input.insert(input.end(), frame.begin(), frame.end());
+            expected += data;
+
+            if (i % 16 == 0) {
+                auto const skippable = as_bytes(kSkippableFrame);
+                input.insert(input.end(), skippable.begin(), skippable.end());
+            }
+        }
+
+        ZstdDecoder serial;
+        serial.set_parallel_decode_threshold(0);
+        auto ret = serial.decode(input);
+        a.require(ret.has_value());
+        a.expect_eq(std::string_view{reinterpret_cast<char const *>(ret->data()), ret->size()}, expected);
+
+        ZstdDecoder parallel;
+        parallel.set_parallel_decode_threshold(1);
+        parallel.set_max_parallel_jobs(4);
+        ret = parallel.decode(input);
+        a.require(ret.has_value());
+        a.expect_eq(std::string_view{reinterpret_cast<char const *>(ret->data()), ret->size()}, expected);
+
+        parallel.set_max_output_length(expected.size() - 1);
+        a.expect_eq(parallel.decode(input), tl::unexpected{ZstdError::MaximumOutputLengthExceeded});
+
+        parallel.set_max_output_length(expected.size());
+        input.pop_back();
+        a.expect_eq(parallel.decode(input), tl::unexpected{ZstdError::DecodeEarlyTermination});
+
+        input.insert(input.begin(), std::byte{0});
+        a.expect_eq(parallel.decode(input), tl::unexpected{ZstdError::ZstdInternalError});
+    });
+
+    s.add_test("output limit is shared by parallel jobs", [](etest::IActions &a) {
+        std::vector<std::byte> input;
+        for (char c : {'a', 'b'}) {
+            auto const frame = make_raw_frame(std::string(200, c));
+            input.insert(input.end(), frame.begin(), frame.end());
+        }
+
+        // Each job decodes one frame, which fits under the limit on its own.
+        ZstdDecoder decoder;
+        decoder.set_parallel_decode_threshold(1);
+        decoder.set_max_parallel_jobs(2);
+        decoder.set_max_output_length(300);
+        a.expect_eq(decoder.decode(input), tl::unexpected{ZstdError::MaximumOutputLengthExceeded});
+
+        decoder.set_max_output_length(400);
+        auto ret = decoder.decode(input);
+        a.require(ret.has_value());
+        a.expect_eq(std::string_view{reinterpret_cast<char const *>(ret->data()), ret->size()},
+                std::string(200, 'a') + std::string(200, 'b'));
+    });
+
+    s.add_test("raw dictionary", [](etest::IActions &a) {
+        // zstd --no-check -D dict.txt in.txt
+        constexpr auto kCompress = std::to_array<std::uint8_t>({0x28, 0xb5, 0x2f, 0xfd, 0x20, 0x5c, 0x9d, 0x00,
+                0x00, 0x50, 0x64, 0x69, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x61, 0x72, 0x79, 0x02, 0x00, 0x5f, 0xd0,
+                0x38, 0x4d, 0x0a, 0x40});
+        constexpr auto kDictionary =
+                "<html><head><title>Example page</title></head><body><p>Hello, world!</p></body></html>\n"sv;
+
+        a.expect_eq(zstd_decode(as_bytes(kCompress)), tl::unexpected{ZstdError::ZstdInternalError});
+
+        ZstdDecoder decoder;
+        decoder.set_dictionary({reinterpret_cast<std::byte const *>(kDictionary.data()), kDictionary.size()});
+        auto ret = decoder.decode(as_bytes(kCompress));
+        a.require(ret.has_value());
+        a.expect_eq(std::string_view{reinterpret_cast<char const *>(ret->data()), ret->size()},
+                "<html><head><title>Example page</title></head><body><p>Hello, dictionary!</p></body></html>\n");
+    });
+
     s.add_test("all error codes can be printed", [](etest::IActions &a) {
         static constexpr auto kFirstError = ZstdError::DecodeEarlyTermination;
         static constexpr auto kLastError = ZstdError::ZstdInternalError;
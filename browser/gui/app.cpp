@@ -80,7 +80,7 @@ std::future<ResourceResult> load_image(engine::Engine &e, uri::Uri uri, std::str
     return std::async(std::launch::async, [&e, uri = std::move(uri), resource_id = std::move(id)]() mutable {
         spdlog::info("Loading image from '{}'", uri.uri);
         auto start_time = std::chrono::steady_clock::now();
-        auto res = e.load(uri);
+        auto res = e.load(uri, "image");
         auto end_time = std::chrono::steady_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
         spdlog::info("Loaded image from '{}' in {}ms", uri.uri, duration.count());
@@ -115,7 +115,7 @@ std::optional<std::string_view> try_get_uri(layout::LayoutBox const *from) {
 
     for (auto const *node = from->node; node != nullptr; node = node->parent) {
         auto const *element = std::get_if<dom::Element>(&node->node);
-        if ((element != nullptr) && element->name == "a"sv && element->attributes.contains("href")) {
+        if ((element != nullptr) && element->name == dom::Atom::known("a") && element->attributes.contains("href")) {
             return element->attributes.at("href");
         }
     }
@@ -137,7 +137,7 @@ std::string element_text(layout::LayoutBox const *element) {
         return std::string{*text};
     }
 
-    return std::get<dom::Element>(element->node->node).name;
+    return std::string{std::get<dom::Element>(element->node->node).name.str()};
 }
 
 template<std::size_t WidthT, std::size_t HeightT>
@@ -232,31 +232,16 @@ std::unique_ptr<type::IType> create_font_system() {
     return type;
 }
 
+// Looks at the DOM rather than the layout, so images that aren't rendered are
+// loaded as well, same as in other browsers.
 std::vector<std::string_view> collect_image_urls(
-        layout::LayoutBox const &root, std::span<std::string_view const> file_endings) {
+        dom::Document const &document, std::span<std::string_view const> file_endings) {
     std::vector<std::string_view> image_urls;
-
-    std::vector<layout::LayoutBox const *> to_check{&root};
-    while (!to_check.empty()) {
-        auto const *current = to_check.back();
-        to_check.pop_back();
-
-        for (auto const &child : current->children) {
-            to_check.push_back(&child);
-        }
-
-        if (current->is_anonymous_block()) {
-            continue;
-        }
-
-        if (auto const *element = std::get_if<dom::Element>(&current->node->node);
-                element != nullptr && element->name == "img"sv) {
-            if (auto it = element->attributes.find("src"); it != end(element->attributes)) {
-                std::string_view src = it->second;
-                if (std::ranges::any_of(
-                            file_endings, [src](std::string_view ending) { return src.ends_with(ending); })) {
-                    image_urls.push_back(src);
-                }
+    for (auto const *element : document.elements_by_tag(dom::Atom::known("img"))) {
+        if (auto it = element->attributes.find(dom::Atom::known("src")); it != element->attributes.end()) {
+            std::string_view src = it->second;
+            if (std::ranges::any_of(file_endings, [src](std::string_view ending) { return src.ends_with(ending); })) {
+                image_urls.push_back(src);
             }
         }
     }
@@ -269,7 +254,8 @@ std::vector<std::string_view> collect_image_urls(
 // Latest Firefox ESR user agent (on Windows). This matches what the Tor browser does.
 App::App(std::string browser_title, std::string start_page_hint, bool load_start_page)
     : engine_{std::make_unique<protocol::InMemoryCache>(protocol::HandlerFactory::create(
-                      "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:102.0) Gecko/20100101 Firefox/102.0")),
+                      "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:102.0) Gecko/20100101 Firefox/102.0",
+                      dictionaries_)),
               create_font_system(),
               [this](std::string_view url) -> std::optional<layout::Size> {
                   auto it = images_.find(url);
@@ -283,6 +269,7 @@ App::App(std::string browser_title, std::string start_page_hint, bool load_start
       window_{sf::VideoMode({kDefaultResolutionX, kDefaultResolutionY}), browser_title_},
       url_buf_{std::move(start_page_hint)},
       canvas_{std::make_unique<gfx::SfmlCanvas>(window_, static_cast<type::SfmlType &>(engine_.font_system()))} {
+    engine_.set_dictionary_store(dictionaries_);
     window_.setIcon({16, 16}, kBrowserIcon.data());
     if (!ImGui::SFML::Init(window_)) {
         spdlog::critical("imgui-sfml initialization failed");
@@ -685,7 +672,7 @@ void App::on_page_loaded() {
     // https://developer.mozilla.org/en-US/docs/Web/HTML/Attributes/rel#icon
     auto is_favicon_link = [](dom::Element const *v) {
         auto rel = v->attributes.find("rel");
-        return rel != end(v->attributes) && rel->second == "icon" && v->attributes.contains("href");
+        return rel != v->attributes.end() && rel->second == "icon" && v->attributes.contains("href");
     };
 
     auto links = dom::nodes_by_xpath(page().dom.html(), "/html/head/link");
@@ -701,7 +688,7 @@ void App::on_page_loaded() {
             continue;
         }
 
-        auto icon = engine_.load(*uri).response;
+        auto icon = engine_.load(*uri, "image").response;
         sf::Image favicon;
         if (!icon.has_value()) {
             spdlog::warn("Error loading favicon from '{}': {}", uri->uri, to_string(icon.error().err));
@@ -820,7 +807,7 @@ void App::run_debug_widget() const {
     if (ImGui::Button("Status line")) {
         auto const &status = [this] {
             if (maybe_page_) {
-                return page().response.status_line;
+                return page().status_line;
             }
 
             return maybe_page_.error().response.status_line.value_or(protocol::StatusLine{});
@@ -831,15 +818,17 @@ void App::run_debug_widget() const {
     }
 
     if (ImGui::Button("Response headers")) {
-        std::cout << "\nResponse headers:\n" << page().response.headers.to_string() << '\n';
+        std::cout << "\nResponse headers:\n" << page().headers.to_string() << '\n';
     }
 
     if (ImGui::Button("Response body")) {
-        std::cout << "\nResponse body:\n" << page().response.body << '\n';
+        std::cout << "\nResponse body:\n" << page().dom.source() << '\n';
     }
 
     if (ImGui::Button("DOM")) {
-        std::cout << "\nDOM:\n" << to_string(page().dom) << '\n';
+        std::cout << "\nDOM:\n";
+        dom::print(page().dom, std::cout);
+        std::cout << '\n';
     }
 
     if (ImGui::Button("Stylesheet")) {
@@ -852,7 +841,9 @@ void App::run_debug_widget() const {
 
     if (ImGui::Button("Layout")) {
         assert(layout);
-        std::cout << "\nLayout:\n" << to_string(*layout) << '\n';
+        std::cout << "\nLayout:\n";
+        layout::print(*layout, std::cout);
+        std::cout << '\n';
     }
 
     ImGui::EndDisabled();
@@ -913,7 +904,7 @@ void App::switch_canvas() {
 void App::start_loading_images() {
     if (auto const &layout = page().layout; layout.has_value()) {
         constexpr static auto kSupportedImageTypes = std::to_array<std::string_view>({".png"sv, ".jpg"sv, ".jpeg"sv});
-        auto image_urls = collect_image_urls(*layout, kSupportedImageTypes);
+        auto image_urls = collect_image_urls(page().dom, kSupportedImageTypes);
         for (auto const &url : image_urls) {
             auto uri = uri::Uri::parse(std::string{url}, page().uri);
             if (!uri) {
@@ -937,6 +928,7 @@ engine::Options App::make_options() const {
             .layout_width = static_cast<int>(window_.getSize().x / scale_),
             .viewport_height = static_cast<int>(window_.getSize().y / scale_),
             .dark_mode = os::is_dark_mode(),
+            .style_threads = std::thread::hardware_concurrency(),
     };
 }
 
@@ -9,6 +9,7 @@
 #include "geom/geom.h"
 #include "gfx/icanvas.h"
 #include "layout/layout_box.h"
+#include "protocol/dictionary_store.h"
 #include "protocol/response.h"
 #include "uri/uri.h"
 #include "util/history.h"
@@ -51,6 +52,9 @@ public:
     int run();
 
 private:
+    // Shared by the protocol handlers advertising dictionaries and the engine
+    // storing and decoding with them, so it's created before either.
+    std::shared_ptr<protocol::DictionaryStore> dictionaries_{std::make_shared<protocol::DictionaryStore>()};
     engine::Engine engine_;
     tl::expected<std::unique_ptr<engine::PageState>, engine::NavigationError> maybe_page_{
             tl::unexpected<engine::NavigationError>{{}}};
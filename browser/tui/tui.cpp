@@ -5,6 +5,7 @@
 #include "tui/tui.h"
 #include "dom/dom.h"
 #include "engine/engine.h"
+#include "protocol/dictionary_store.h"
 #include "protocol/handler_factory.h"
 #include "protocol/response.h"
 #include "uri/uri.h"
@@ -52,7 +53,9 @@ int main(int argc, char **argv) {
 
     // Latest Firefox ESR user agent (on Windows). This matches what the Tor browser does.
     auto user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:102.0) Gecko/20100101 Firefox/102.0"s;
-    engine::Engine engine{protocol::HandlerFactory::create(std::move(user_agent))};
+    auto dictionaries = std::make_shared<protocol::DictionaryStore>();
+    engine::Engine engine{protocol::HandlerFactory::create(std::move(user_agent), dictionaries)};
+    engine.set_dictionary_store(std::move(dictionaries));
     auto maybe_page = engine.navigate(*uri);
     if (!maybe_page) {
         spdlog::error(R"(Error loading "{}": {})", uri->uri, to_string(maybe_page.error().response.err));
@@ -61,7 +64,7 @@ int main(int argc, char **argv) {
 
     auto page = std::move(*maybe_page);
 
-    std::cout << dom::to_string(page->dom);
+    dom::print(page->dom, std::cout);
     spdlog::info("Building TUI");
 
     auto const &layout = page->layout;
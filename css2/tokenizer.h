@@ -31,19 +31,41 @@ enum class ParseError : std::uint8_t {
 
 std::string_view to_string(ParseError);
 
-class Tokenizer {
+// Delivers tokens and parse errors using std::function, for when being able to
+// pass in any callable is worth more than having the token handling inlined.
+class FunctionSink {
 public:
-    Tokenizer(std::string_view input, std::function<void(Token &&)> on_emit, std::function<void(ParseError)> on_error)
-        : input_(input), on_emit_(std::move(on_emit)), on_error_(std::move(on_error)) {}
+    FunctionSink(std::function<void(Token &&)> on_emit, std::function<void(ParseError)> on_error)
+        : on_emit_{std::move(on_emit)}, on_error_{std::move(on_error)} {}
+
+    void on_token(Token &&token) { on_emit_(std::move(token)); }
+    void on_error(ParseError error) { on_error_(error); }
+
+private:
+    std::function<void(Token &&)> on_emit_;
+    std::function<void(ParseError)> on_error_;
+};
+
+// Tokens and parse errors are delivered to the sink's on_token(Token &&) and
+// on_error(ParseError), which are called directly, so they can be inlined. The
+// implementation lives in css2/tokenizer_impl.h.
+template<typename Sink>
+class BasicTokenizer {
+public:
+    template<typename... SinkArgs>
+    BasicTokenizer(std::string_view input, SinkArgs &&...sink_args)
+        : input_(input), sink_(std::forward<SinkArgs>(sink_args)...) {}
 
     void run();
 
+    Sink &sink() { return sink_; }
+    Sink const &sink() const { return sink_; }
+
 private:
     std::string_view input_;
     std::size_t pos_{0};
 
-    std::function<void(Token &&)> on_emit_;
-    std::function<void(ParseError)> on_error_;
+    Sink sink_;
 
     void emit(ParseError);
     void emit(Token &&);
@@ -65,6 +87,9 @@ private:
     void consume_comments();
 };
 
+using Tokenizer = BasicTokenizer<FunctionSink>;
+extern template class BasicTokenizer<FunctionSink>;
+
 } // namespace css2
 
 #endif
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "css2/tokenizer.h"
+#include "css2/tokenizer_impl.h"
+
+#include "css2/token.h"
+
+#include "etest/etest2.h"
+
+#include <nanobench.h>
+
+#include <cstddef>
+#include <format>
+#include <string>
+
+namespace {
+
+// Lots of small tokens, which is where the per-token overhead matters.
+std::string make_style_sheet() {
+    std::string css;
+    for (int i = 0; i < 1000; ++i) {
+        css += std::format(".item-{} > a:hover, #nav li {{ color: #fff; margin: 0 1px 2em {}%; }}\n", i, i % 100);
+    }
+    return css;
+}
+
+struct CountingSink {
+    std::size_t tokens{};
+    void on_token(css2::Token &&) { ++tokens; }
+    void on_error(css2::ParseError) {}
+};
+
+} // namespace
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("tokenizer: token sinks", [](etest::IActions &a) {
+        auto const css = make_style_sheet();
+
+        std::size_t function_tokens{};
+        auto tokenize_with_function = [&] {
+            function_tokens = 0;
+            css2::Tokenizer{css, [&](css2::Token &&) { ++function_tokens; }, [](css2::ParseError) {}}.run();
+        };
+
+        std::size_t static_tokens{};
+        auto tokenize_with_static_sink = [&] {
+            css2::BasicTokenizer<CountingSink> tokenizer{css};
+            tokenizer.run();
+            static_tokens = tokenizer.sink().tokens;
+        };
+
+        tokenize_with_function();
+        tokenize_with_static_sink();
+        a.expect_eq(function_tokens, static_tokens);
+
+        ankerl::nanobench::Bench bench;
+        bench.title("tokenizer: token sinks").unit("token").batch(static_tokens);
+        bench.run("std::function", tokenize_with_function);
+        bench.run("static sink", tokenize_with_static_sink);
+    });
+
+    return s.run();
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/atom.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace dom {
+namespace {
+
+struct DynamicAtomData : detail::AtomData {
+    explicit DynamicAtomData(std::string_view s) : storage{s} { name = storage; }
+
+    mutable std::atomic<std::size_t> refs{1};
+    std::string storage;
+};
+
+using StaticAtomTable = std::unordered_map<std::string_view, detail::AtomData const *>;
+
+StaticAtomTable const &static_atoms() {
+    static StaticAtomTable const table = [] {
+        StaticAtomTable t;
+        t.reserve(detail::kStaticAtomData.size());
+        for (auto const &entry : detail::kStaticAtomData) {
+            t.emplace(entry.name, &entry);
+        }
+        return t;
+    }();
+    return table;
+}
+
+// Lookups increment the reference count, and the last atom referring to a
+// name drops it, while holding the lock, so a name can't be found while it's
+// being removed.
+struct DynamicAtomTable {
+    std::mutex mtx;
+    std::unordered_map<std::string_view, DynamicAtomData *> atoms;
+};
+
+DynamicAtomTable &dynamic_atoms() {
+    // Leaked so that atoms in other static objects can outlive it.
+    static auto *table = new DynamicAtomTable{};
+    return *table;
+}
+
+} // namespace
+
+std::size_t detail::dynamic_atom_count() {
+    auto &table = dynamic_atoms();
+    std::scoped_lock lock{table.mtx};
+    return table.atoms.size();
+}
+
+Atom::Atom(std::string_view name) {
+    if (auto it = static_atoms().find(name); it != static_atoms().end()) {
+        data_ = it->second;
+        return;
+    }
+
+    auto &table = dynamic_atoms();
+    std::scoped_lock lock{table.mtx};
+    if (auto it = table.atoms.find(name); it != table.atoms.end()) {
+        it->second->refs.fetch_add(1, std::memory_order_relaxed);
+        data_ = it->second;
+        return;
+    }
+
+    auto *data = new DynamicAtomData{name};
+    table.atoms.emplace(data->name, data);
+    data_ = data;
+}
+
+void Atom::retain() const {
+    static_cast<DynamicAtomData const *>(data_)->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Atom::release() const {
+    auto const *data = static_cast<DynamicAtomData const *>(data_);
+
+    // Only the last reference has to take the lock.
+    auto refs = data->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (data->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    auto &table = dynamic_atoms();
+    std::scoped_lock lock{table.mtx};
+    if (data->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        table.atoms.erase(data->name);
+        delete data;
+    }
+}
+
+} // namespace dom
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef DOM_ATOM_H_
+#define DOM_ATOM_H_
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace dom {
+namespace detail {
+
+// HTML element and attribute names, sorted so that they can be looked up at
+// compile time. The empty string is first so that it's the default atom.
+inline constexpr auto kStaticAtoms = std::to_array<std::string_view>({
+            "", "a", "abbr", "accept", "accept-charset", "accesskey", "action", "address", "align", "allow", "alt",
+            "applet", "area", "article", "aside", "async", "audio", "autocapitalize", "autocomplete", "autofocus",
+            "autoplay", "b", "background", "base", "basefont", "bdi", "bdo", "bgcolor", "bgsound", "big", "blockquote",
+            "body", "border", "br", "button", "canvas", "caption", "center", "charset", "checked", "cite", "class",
+            "code", "col", "colgroup", "color", "cols", "colspan", "content", "contenteditable", "controls", "coords",
+            "crossorigin", "data", "datalist", "datetime", "dd", "decoding", "default", "defer", "del", "details",
+            "dfn", "dialog", "dir", "dirname", "disabled", "div", "dl", "download", "draggable", "dt", "em", "embed",
+            "enctype", "enterkeyhint", "face", "fieldset", "figcaption", "figure", "font", "footer", "for", "form",
+            "formaction", "frame", "frameset", "h1", "h2", "h3", "h4", "h5", "h6", "head", "header", "headers",
+            "height", "hgroup", "hidden", "high", "hr", "href", "hreflang", "html", "http-equiv", "i", "id", "iframe",
+            "image", "img", "inert", "input", "inputmode", "ins", "integrity", "is", "itemprop", "kbd", "keygen",
+            "kind", "label", "lang", "legend", "li", "link", "list", "listing", "loading", "loop", "low", "main", "map",
+            "mark", "marquee", "math", "max", "maxlength", "media", "menu", "meta", "meter", "method", "min",
+            "minlength", "multiple", "muted", "name", "nav", "nobr", "noembed", "noframes", "nonce", "noscript",
+            "novalidate", "object", "ol", "open", "optgroup", "optimum", "option", "output", "p", "param", "pattern",
+            "picture", "ping", "placeholder", "plaintext", "playsinline", "popover", "poster", "pre", "preload",
+            "progress", "q", "rb", "readonly", "referrerpolicy", "rel", "required", "reversed", "rows", "rowspan", "rp",
+            "rt", "rtc", "ruby", "s", "samp", "sandbox", "scope", "script", "search", "section", "select", "selected",
+            "shape", "size", "sizes", "slot", "small", "source", "span", "spellcheck", "src", "srcdoc", "srclang",
+            "srcset", "start", "step", "strike", "strong", "style", "sub", "summary", "sup", "svg", "tabindex", "table",
+            "target", "tbody", "td", "template", "textarea", "tfoot", "th", "thead", "time", "title", "tr", "track",
+            "translate", "tt", "type", "u", "ul", "usemap", "valign", "value", "var", "video", "wbr", "width", "wrap",
+            "xmp",
+});
+
+// Atoms point to one of these. The static ones are in kStaticAtomData, and
+// every other name gets its own, which is freed when its last atom is.
+struct AtomData {
+    std::string_view name;
+};
+
+inline constexpr auto kStaticAtomData = [] {
+    std::array<AtomData, kStaticAtoms.size()> data{};
+    for (std::size_t i = 0; i < kStaticAtoms.size(); ++i) {
+        data[i].name = kStaticAtoms[i];
+    }
+    return data;
+}();
+
+// The number of names not in kStaticAtoms that atoms currently exist for.
+std::size_t dynamic_atom_count();
+
+} // namespace detail
+
+// A tag or attribute name. Every name is interned, so two atoms are equal iff
+// they point to the same entry, comparing them is a pointer compare, and an
+// element's name is a pointer rather than a copy of the string.
+//
+// Names in detail::kStaticAtoms are never freed. Other names are reference
+// counted and removed from the intern table once no atom refers to them, so
+// that unusual names don't keep memory alive after the pages using them are
+// gone.
+class Atom {
+public:
+    // A name in detail::kStaticAtoms, looked up at compile time.
+    class Known {
+    public:
+        // Fails to compile if the name isn't in the static table.
+        // NOLINTNEXTLINE(google-explicit-constructor): Used for Atom::known("div").
+        consteval Known(char const *name) {
+            auto it = std::ranges::lower_bound(detail::kStaticAtoms, std::string_view{name});
+            if (it == detail::kStaticAtoms.end() || *it != name) {
+                std::abort();
+            }
+
+            data_ = &detail::kStaticAtomData[static_cast<std::size_t>(it - detail::kStaticAtoms.begin())];
+        }
+
+    private:
+        friend class Atom;
+        detail::AtomData const *data_{};
+    };
+
+    static constexpr Atom known(Known name) { return Atom{name.data_}; }
+
+    constexpr Atom() = default;
+    // NOLINTBEGIN(google-explicit-constructor): Atoms are used in place of strings.
+    Atom(std::string_view);
+    Atom(char const *name) : Atom{std::string_view{name}} {}
+    Atom(std::string const &name) : Atom{std::string_view{name}} {}
+    constexpr operator std::string_view() const { return str(); }
+    // NOLINTEND(google-explicit-constructor)
+
+    constexpr Atom(Atom const &other) : data_{other.data_} {
+        if (is_dynamic()) {
+            retain();
+        }
+    }
+
+    constexpr Atom(Atom &&other) noexcept : data_{std::exchange(other.data_, detail::kStaticAtomData.data())} {}
+
+    constexpr Atom &operator=(Atom const &other) {
+        Atom copy{other};
+        std::swap(data_, copy.data_);
+        return *this;
+    }
+
+    constexpr Atom &operator=(Atom &&other) noexcept {
+        std::swap(data_, other.data_);
+        return *this;
+    }
+
+    constexpr ~Atom() {
+        if (is_dynamic()) {
+            release();
+        }
+    }
+
+    constexpr std::string_view str() const { return data_->name; }
+    constexpr bool empty() const { return str().empty(); }
+    std::size_t hash() const { return std::hash<detail::AtomData const *>{}(data_); }
+
+    [[nodiscard]] constexpr bool operator==(Atom const &other) const { return data_ == other.data_; }
+    constexpr std::strong_ordering operator<=>(Atom const &other) const { return str() <=> other.str(); }
+
+    template<typename T>
+    requires(std::convertible_to<T const &, std::string_view> && !std::same_as<T, Atom>)
+    [[nodiscard]] constexpr bool operator==(T const &other) const {
+        return str() == std::string_view{other};
+    }
+
+    template<typename T>
+    requires(std::convertible_to<T const &, std::string_view> && !std::same_as<T, Atom>)
+    constexpr std::strong_ordering operator<=>(T const &other) const {
+        return str() <=> std::string_view{other};
+    }
+
+private:
+    constexpr explicit Atom(detail::AtomData const *data) : data_{data} {}
+
+    // Static atoms always point into kStaticAtomData, so this is only ever
+    // comparing pointers into the same array during constant evaluation.
+    constexpr bool is_dynamic() const {
+        auto const *first = detail::kStaticAtomData.data();
+        auto const *last = first + detail::kStaticAtomData.size();
+        return std::less<>{}(data_, first) || !std::less<>{}(data_, last);
+    }
+
+    void retain() const;
+    void release() const;
+
+    detail::AtomData const *data_{detail::kStaticAtomData.data()};
+};
+
+} // namespace dom
+
+template<>
+struct std::hash<dom::Atom> {
+    std::size_t operator()(dom::Atom const &atom) const { return atom.hash(); }
+};
+
+#endif
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/atom.h"
+
+#include "etest/etest2.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace std::literals;
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("static table", [](etest::IActions &a) {
+        a.expect(std::ranges::is_sorted(dom::detail::kStaticAtoms));
+        a.expect(std::ranges::adjacent_find(dom::detail::kStaticAtoms) == dom::detail::kStaticAtoms.end());
+    });
+
+    s.add_test("known atoms", [](etest::IActions &a) {
+        a.expect_eq(dom::Atom::known("div").str(), "div"sv);
+        a.expect(dom::Atom::known("div") == dom::Atom::known("div"));
+        a.expect(dom::Atom::known("div") != dom::Atom::known("span"));
+        a.expect(dom::Atom{} == dom::Atom::known(""));
+        a.expect(dom::Atom{}.empty());
+    });
+
+    s.add_test("interning", [](etest::IActions &a) {
+        a.expect(dom::Atom{"br"} == dom::Atom::known("br"));
+        a.expect(dom::Atom{"br"s} == dom::Atom{"br"sv});
+        a.expect(dom::Atom{""} == dom::Atom{});
+
+        // Not in the static table.
+        dom::Atom custom{"my-element"};
+        a.expect_eq(custom.str(), "my-element"sv);
+        a.expect(custom == dom::Atom{std::string{"my-"} + "element"});
+        a.expect(custom != dom::Atom{"my-other-element"});
+        a.expect_eq(std::hash<dom::Atom>{}(custom), std::hash<dom::Atom>{}(dom::Atom{"my-element"}));
+        a.expect(custom != dom::Atom::known("div"));
+        a.expect(dom::Atom{} != dom::Atom{"my-element"});
+        a.expect(!custom.empty());
+    });
+
+    s.add_test("size", [](etest::IActions &a) {
+        a.expect_eq(sizeof(dom::Atom), sizeof(void *)); //
+    });
+
+    s.add_test("dynamic atoms are freed with their last reference", [](etest::IActions &a) {
+        auto const before = dom::detail::dynamic_atom_count();
+        {
+            dom::Atom custom{"my-freed-element"};
+            a.expect_eq(dom::detail::dynamic_atom_count(), before + 1);
+
+            auto copy = custom;
+            dom::Atom again{"my-freed-element"};
+            a.expect_eq(dom::detail::dynamic_atom_count(), before + 1);
+
+            auto moved = std::move(copy);
+            a.expect(moved == custom);
+            a.expect(again == custom);
+            // NOLINTNEXTLINE(bugprone-use-after-move): Moved-from atoms are empty.
+            a.expect(copy.empty());
+
+            custom = dom::Atom::known("div");
+            a.expect_eq(dom::detail::dynamic_atom_count(), before + 1);
+        }
+
+        a.expect_eq(dom::detail::dynamic_atom_count(), before);
+
+        // Static atoms aren't counted.
+        dom::Atom div{"div"};
+        a.expect_eq(dom::detail::dynamic_atom_count(), before);
+    });
+
+    s.add_test("comparison with strings", [](etest::IActions &a) {
+        dom::Atom p{"p"};
+        a.expect(p == "p");
+        a.expect(p == "p"sv);
+        a.expect(p == "p"s);
+        a.expect("p" == p);
+        a.expect(p != "pre");
+
+        a.expect(dom::Atom{"a"} < dom::Atom{"b"});
+        a.expect(dom::Atom{"zzz"} > dom::Atom{"a"});
+        a.expect(dom::Atom{"a"} < "b"sv);
+    });
+
+    return s.run();
+}
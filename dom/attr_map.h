@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef DOM_ATTR_MAP_H_
+#define DOM_ATTR_MAP_H_
+
+#include "dom/atom.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dom {
+
+// An element's attributes, stored flat in the order they were added. Most
+// elements have only a handful of attributes, so a linear scan comparing
+// atoms beats walking a tree of separately allocated nodes.
+//
+// The interface is the subset of std::map's used for attributes.
+class AttrMap {
+public:
+    using key_type = Atom;
+    using mapped_type = std::string;
+    using value_type = std::pair<Atom, std::string>;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+    using iterator = std::pmr::vector<value_type>::iterator;
+    using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+    AttrMap() = default;
+    explicit AttrMap(allocator_type const &alloc) : attributes_(alloc) {}
+
+    // Like std::map, only the first of any duplicate names is kept.
+    AttrMap(std::initializer_list<value_type> init, allocator_type const &alloc = {}) : attributes_(alloc) {
+        attributes_.reserve(init.size());
+        for (auto const &attribute : init) {
+            if (!contains(attribute.first)) {
+                attributes_.push_back(attribute);
+            }
+        }
+    }
+
+    allocator_type get_allocator() const { return attributes_.get_allocator(); }
+
+    iterator begin() { return attributes_.begin(); }
+    const_iterator begin() const { return attributes_.begin(); }
+    iterator end() { return attributes_.end(); }
+    const_iterator end() const { return attributes_.end(); }
+
+    bool empty() const { return attributes_.empty(); }
+    std::size_t size() const { return attributes_.size(); }
+    void clear() { attributes_.clear(); }
+    void reserve(std::size_t size) { attributes_.reserve(size); }
+
+    // Looking up an Atom is a pointer comparison per attribute, so prefer
+    // that, e.g. find(Atom::known("class")), over looking up a string.
+    iterator find(Atom name) {
+        return std::ranges::find(attributes_, name, &value_type::first);
+    }
+
+    const_iterator find(Atom name) const {
+        return std::ranges::find(attributes_, name, &value_type::first);
+    }
+
+    template<typename T>
+    requires(std::convertible_to<T const &, std::string_view> && !std::same_as<T, Atom>)
+    iterator find(T const &name) {
+        return std::ranges::find_if(attributes_, [&](value_type const &a) { return a.first == name; });
+    }
+
+    template<typename T>
+    requires(std::convertible_to<T const &, std::string_view> && !std::same_as<T, Atom>)
+    const_iterator find(T const &name) const {
+        return std::ranges::find_if(attributes_, [&](value_type const &a) { return a.first == name; });
+    }
+
+    template<typename T>
+    bool contains(T const &name) const {
+        return find(name) != end();
+    }
+
+    // Throws std::out_of_range if the attribute is missing, like std::map.
+    template<typename T>
+    std::string &at(T const &name) {
+        return attributes_.at(static_cast<std::size_t>(find(name) - begin())).second;
+    }
+
+    template<typename T>
+    std::string const &at(T const &name) const {
+        return attributes_.at(static_cast<std::size_t>(find(name) - begin())).second;
+    }
+
+    std::string &operator[](Atom name) {
+        if (auto it = find(name); it != end()) {
+            return it->second;
+        }
+
+        return attributes_.emplace_back(name, std::string{}).second;
+    }
+
+    // Attribute order doesn't matter when comparing elements.
+    [[nodiscard]] bool operator==(AttrMap const &other) const {
+        return size() == other.size() && std::ranges::all_of(attributes_, [&](value_type const &a) {
+            auto it = other.find(a.first);
+            return it != other.end() && it->second == a.second;
+        });
+    }
+
+private:
+    std::pmr::vector<value_type> attributes_;
+};
+
+} // namespace dom
+
+#endif
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/attr_map.h"
+
+#include "dom/atom.h"
+
+#include "etest/etest2.h"
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("lookup", [](etest::IActions &a) {
+        dom::AttrMap attrs{{"class", "a b"}, {"data-thing", "1"}};
+        a.expect_eq(attrs.size(), std::size_t{2});
+        a.expect(!attrs.empty());
+
+        a.expect(attrs.contains("class"));
+        a.expect(attrs.contains("class"sv));
+        a.expect(attrs.contains("class"s));
+        a.expect(attrs.contains(dom::Atom::known("class")));
+        a.expect(attrs.contains(dom::Atom{"data-thing"}));
+        a.expect(!attrs.contains("id"));
+        a.expect(!attrs.contains(dom::Atom::known("id")));
+
+        a.expect_eq(attrs.at("class"), "a b");
+        a.expect_eq(attrs.find(dom::Atom::known("class"))->second, "a b");
+        a.expect(attrs.find("id") == attrs.end());
+        a.expect_eq(attrs.at(dom::Atom{"data-thing"}), "1");
+    });
+
+    s.add_test("insertion", [](etest::IActions &a) {
+        dom::AttrMap attrs;
+        a.expect(attrs.empty());
+
+        attrs["id"] = "hello";
+        attrs["href"] = "/";
+        attrs["id"] = "goodbye";
+        a.expect_eq(attrs.size(), std::size_t{2});
+        a.expect_eq(attrs.at("id"), "goodbye");
+
+        // Insertion order is kept.
+        a.expect_eq(attrs.begin()->first.str(), "id"sv);
+
+        attrs.clear();
+        a.expect(attrs.empty());
+    });
+
+    s.add_test("duplicates in initializer list", [](etest::IActions &a) {
+        dom::AttrMap attrs{{"id", "1"}, {"id", "2"}};
+        a.expect_eq(attrs.size(), std::size_t{1});
+        a.expect_eq(attrs.at("id"), "1");
+    });
+
+    s.add_test("comparison ignores order", [](etest::IActions &a) {
+        a.expect(dom::AttrMap{{"a", "1"}, {"b", "2"}} == dom::AttrMap{{"b", "2"}, {"a", "1"}});
+        a.expect(dom::AttrMap{{"a", "1"}, {"b", "2"}} != dom::AttrMap{{"b", "1"}, {"a", "2"}});
+        a.expect(dom::AttrMap{{"a", "1"}} != dom::AttrMap{{"a", "1"}, {"b", "2"}});
+    });
+
+    s.add_test("allocator", [](etest::IActions &a) {
+        std::pmr::monotonic_buffer_resource arena;
+        dom::AttrMap attrs{&arena};
+        attrs["id"] = "hello";
+        a.expect(attrs.get_allocator().resource() == &arena);
+    });
+
+    return s.run();
+}
@@ -4,10 +4,16 @@
 
 #include "dom/dom.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <ranges>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -25,9 +31,9 @@ void print_whitespace(std::ostream &os, int depth) {
     }
 }
 
-void print_attribute(std::pair<std::string, std::string> const &attribute, std::ostream &os, int depth) {
+void print_attribute(AttrMap::value_type const &attribute, std::ostream &os, int depth) {
     print_whitespace(os, depth);
-    os << attribute.first << "=\"" << attribute.second << '"';
+    os << attribute.first.str() << "=\"" << attribute.second << '"';
 }
 
 void print_node(dom::Node const &node, std::ostream &os, int initial_depth = 0) {
@@ -39,36 +45,107 @@ void print_node(dom::Node const &node, std::ostream &os, int initial_depth = 0)
         print_whitespace(os, current_depth);
 
         if (auto const *element = std::get_if<dom::Element>(current_node)) {
-            os << '<' << element->name << ">";
+            os << '<' << element->name.str() << ">";
+
+            // Attributes are stored in the order they were added, but printed sorted.
+            std::vector<AttrMap::value_type const *> attributes;
+            attributes.reserve(element->attributes.size());
             for (auto const &attribute : element->attributes) {
-                print_attribute(attribute, os, current_depth + 1);
+                attributes.push_back(&attribute);
+            }
+
+            std::ranges::sort(attributes, {}, [](auto const *attribute) { return attribute->first.str(); });
+            for (auto const *attribute : attributes) {
+                print_attribute(*attribute, os, current_depth + 1);
             }
 
             for (auto const &child : element->children | std::views::reverse) {
                 to_print.emplace_back(&child, current_depth + 1);
             }
         } else {
-            os << '"' << std::get<dom::Text>(*current_node).text << '"';
+            os << '"' << std::get<dom::Text>(*current_node).text.str() << '"';
         }
     }
 }
 
 } // namespace
 
-std::string to_string(Document const &document) {
-    std::stringstream ss;
-    ss << "#document\n";
+Document::Document(Document const &other)
+    : source_{other.source_}, doctype{other.doctype}, html_node{other.html_node}, mode{other.mode} {
+    if (other.has_indexes()) {
+        build_indexes();
+    }
+}
+
+Document::Document(Document &&other) noexcept
+    : arena_{std::move(other.arena_)}, source_{std::move(other.source_)}, index_{std::move(other.index_)},
+      doctype{std::move(other.doctype)}, html_node{std::move(other.html_node)}, mode{other.mode} {
+    // Only the root element lives in the document itself, so it's the only
+    // indexed element that moved.
+    index_.rebase(std::get_if<Element>(&other.html_node), std::get_if<Element>(&html_node));
+}
+
+Document &Document::operator=(Document const &other) {
+    return *this = Document{other};
+}
+
+Document &Document::operator=(Document &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    // The old tree has to be destroyed before the arena it was allocated
+    // from, and the new one has to be moved in rather than assigned so that
+    // it keeps its allocator.
+    std::visit([this](auto &node) { html_node.emplace<std::remove_cvref_t<decltype(node)>>(std::move(node)); },
+            other.html_node);
+    arena_ = std::move(other.arena_);
+    source_ = std::move(other.source_);
+    doctype = std::move(other.doctype);
+    mode = other.mode;
+    index_ = std::move(other.index_);
+    index_.rebase(std::get_if<Element>(&other.html_node), std::get_if<Element>(&html_node));
+    return *this;
+}
+
+Element Document::create_element(Atom name) const {
+    return Element{name, AttrMap(allocator()), std::pmr::vector<Node>(allocator())};
+}
+
+std::pmr::polymorphic_allocator<> Document::allocator() const {
+    // A moved-from document has no arena.
+    return arena_ ? arena_.get() : std::pmr::get_default_resource();
+}
+
+bool Document::is_source_of(std::string_view text) const {
+    auto const source = this->source();
+    // std::less, as comparing pointers into different objects with < is unspecified.
+    return !source.empty() && !std::less<>{}(text.data(), source.data())
+            && !std::less<>{}(source.data() + source.size(), text.data() + text.size());
+}
+
+void print(Document const &document, std::ostream &os) {
+    os << "#document\n";
     if (!document.doctype.empty()) {
-        ss << "| <!DOCTYPE " << document.doctype << '>';
+        os << "| <!DOCTYPE " << document.doctype << '>';
     }
 
-    print_node(document.html_node, ss, 1);
+    print_node(document.html_node, os, 1);
+}
+
+void print(Node const &node, std::ostream &os) {
+    print_node(node, os);
+}
+
+std::string to_string(Document const &document) {
+    std::stringstream ss;
+    print(document, ss);
     return std::move(ss).str();
 }
 
-std::string to_string(Node const &element) {
+std::string to_string(Node const &node) {
     std::stringstream ss;
-    print_node(element, ss);
+    print(node, ss);
     return std::move(ss).str();
 }
 
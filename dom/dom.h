@@ -5,11 +5,20 @@
 #ifndef DOM_DOM_H_
 #define DOM_DOM_H_
 
+#include "dom/atom.h"
+#include "dom/attr_map.h"
+#include "dom/element_index.h"
+#include "dom/source_string.h"
+
 #include <cstdint>
-#include <functional>
-#include <map>
+#include <iosfwd>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -18,24 +27,73 @@ namespace dom {
 struct Text;
 struct Element;
 
-using AttrMap = std::map<std::string, std::string, std::less<>>;
 using Node = std::variant<Element, Text>;
 
 struct Text {
-    std::string text;
+    SourceString text;
     [[nodiscard]] bool operator==(Text const &) const = default;
 };
 
 struct Element {
-    std::string name;
+    Atom name;
     AttrMap attributes;
-    std::vector<Node> children;
+    std::pmr::vector<Node> children;
     [[nodiscard]] bool operator==(Element const &) const = default;
 };
 
+// Elements created through the document have their children and attributes
+// allocated from an arena owned by it, which is released all at once when the
+// document is destroyed. Elements built in any other way, including copies,
+// use the default allocator.
+//
+// A document can also keep the source it was parsed from alive, letting text
+// that's unchanged from the source refer to it instead of owning a copy. Text
+// nodes copied out of such a document must not outlive it.
+//
+// Elements can be looked up by id, class, tag, or attribute once the document
+// has been indexed. html::Parser indexes the documents it produces, but
+// anything changing the tree afterwards has to call build_indexes() again, or
+// the lookups will return stale results.
 struct Document {
+    Document() = default;
+    Document(Document const &);
+    Document(Document &&) noexcept;
+    Document &operator=(Document const &);
+    Document &operator=(Document &&) noexcept;
+    ~Document() = default;
+
+    [[nodiscard]] Element create_element(Atom name) const;
+    [[nodiscard]] std::pmr::polymorphic_allocator<> allocator() const;
+
+    void keep_source(std::shared_ptr<std::string const> source) { source_ = std::move(source); }
+    [[nodiscard]] std::string_view source() const { return source_ ? std::string_view{*source_} : std::string_view{}; }
+    // Whether the text is a view into the source, i.e. whether it's safe for
+    // the document to borrow it.
+    [[nodiscard]] bool is_source_of(std::string_view) const;
+
+    void build_indexes() { index_.build(html()); }
+    [[nodiscard]] bool has_indexes() const { return index_.is_built(); }
+
+    // These find nothing if the document hasn't been indexed.
+    [[nodiscard]] Element const *element_by_id(std::string_view id) const { return index_.by_id(id); }
+    [[nodiscard]] std::span<Element const *const> elements_by_tag(Atom name) const { return index_.by_tag(name); }
+    [[nodiscard]] std::span<Element const *const> elements_by_class(std::string_view name) const {
+        return index_.by_class(name);
+    }
+    [[nodiscard]] std::span<Element const *const> elements_with_attribute(Atom name) const {
+        return index_.with_attribute(name);
+    }
+
+private:
+    // Declared before the tree so that they're destroyed after it.
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_{
+            std::make_unique<std::pmr::monotonic_buffer_resource>()};
+    std::shared_ptr<std::string const> source_;
+    ElementIndex index_;
+
+public:
     std::string doctype;
-    Node html_node;
+    Node html_node{create_element({})};
 
     // https://dom.spec.whatwg.org/#concept-document-mode
     enum class Mode : std::uint8_t {
@@ -46,25 +104,25 @@ struct Document {
 
     Element const &html() const { return std::get<Element>(html_node); }
     Element &html() { return std::get<Element>(html_node); }
-    [[nodiscard]] bool operator==(Document const &) const = default;
+    [[nodiscard]] bool operator==(Document const &other) const {
+        return doctype == other.doctype && html_node == other.html_node && mode == other.mode;
+    }
 };
 
 inline std::string_view dom_name(Element const &e) {
     return e.name;
 }
 
-inline std::vector<Element const *> dom_children(Element const &e) {
-    std::vector<Element const *> children;
-    for (auto const &child : e.children) {
-        if (auto const *element = std::get_if<Element>(&child)) {
-            children.push_back(element);
-        }
-    }
-    return children;
+inline auto dom_children(Element const &e) {
+    auto is_element = [](Node const &child) { return std::holds_alternative<Element>(child); };
+    auto to_element = [](Node const &child) { return &std::get<Element>(child); };
+    return e.children | std::views::filter(is_element) | std::views::transform(to_element);
 }
 
 // Prints a dom tree in the format described at
 // https://github.com/html5lib/html5lib-tests/blob/a9f44960a9fedf265093d22b2aa3c7ca123727b9/tree-construction/README.md
+void print(Document const &, std::ostream &);
+void print(Node const &, std::ostream &);
 std::string to_string(Document const &);
 std::string to_string(Node const &);
 
@@ -6,13 +6,20 @@
 
 #include "etest/etest2.h"
 
+#include <cstddef>
+#include <ranges>
+#include <sstream>
 #include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 
 int main() {
     etest::Suite s{"dom"};
 
     s.add_test("to_string(Document)", [](etest::IActions &a) {
-        auto document = dom::Document{.doctype{"html5"}};
+        dom::Document document;
+        document.doctype = "html5";
         document.html_node = dom::Element{
                 .name{"span"},
                 .children{{
@@ -35,6 +42,10 @@ int main() {
                 "|     href=\"https://example.com\"\n"
                 "|     \"go!\"";
         a.expect_eq(to_string(document), expected);
+
+        std::stringstream ss;
+        dom::print(document, ss);
+        a.expect_eq(ss.str(), expected);
     });
 
     s.add_test("to_string(Node)", [](etest::IActions &a) {
@@ -46,7 +57,8 @@ int main() {
     });
 
     s.add_test("to_string(Document) 2", [](etest::IActions &a) {
-        auto document = dom::Document{.doctype{"html5"}};
+        dom::Document document;
+        document.doctype = "html5";
         document.html_node = dom::Element{
                 .name{"html"},
                 .children{{
@@ -72,5 +84,81 @@ int main() {
         a.expect_eq(to_string(document), expected);
     });
 
+    s.add_test("dom_children", [](etest::IActions &a) {
+        dom::Element const e{
+                .name{"div"},
+                .children{dom::Text{"a"}, dom::Element{"p"}, dom::Text{"b"}, dom::Element{"span"}},
+        };
+
+        std::vector<dom::Element const *> children;
+        for (auto const *child : dom_children(e)) {
+            children.push_back(child);
+        }
+
+        a.expect_eq(children,
+                std::vector{&std::get<dom::Element>(e.children.at(1)), &std::get<dom::Element>(e.children.at(3))});
+        a.expect(std::ranges::empty(dom_children(dom::Element{"br"})));
+    });
+
+    s.add_test("elements created by the document use its arena", [](etest::IActions &a) {
+        dom::Document document;
+        a.expect(document.html().children.get_allocator() == document.allocator());
+
+        auto element = document.create_element("p");
+        element.attributes["class"] = "hello";
+        element.children.emplace_back(dom::Text{"goodbye"});
+        a.expect(element.attributes.get_allocator() == document.allocator());
+        a.expect(element.children.get_allocator() == document.allocator());
+        document.html().children.emplace_back(std::move(element));
+
+        // Moving the document moves the arena along with the tree.
+        dom::Document other;
+        auto allocator = document.allocator();
+        other = std::move(document);
+        a.expect(other.allocator() == allocator);
+        a.expect(other.html().children.get_allocator() == allocator);
+        auto const &p = std::get<dom::Element>(other.html().children.at(0));
+        a.expect_eq(p.attributes.at("class"), "hello");
+        a.expect_eq(std::get<dom::Text>(p.children.at(0)).text, "goodbye");
+
+        // Copies don't share the arena.
+        auto copy = other;
+        a.expect(copy == other);
+        a.expect(copy.html().children.get_allocator() != allocator);
+    });
+
+    s.add_test("indexes survive the document being moved or copied", [](etest::IActions &a) {
+        dom::Document document;
+        document.html() = document.create_element("html");
+        auto body = document.create_element("body");
+        body.attributes["id"] = "b";
+        document.html().children.emplace_back(std::move(body));
+        a.expect(!document.has_indexes());
+        a.expect(document.elements_by_tag("html").empty());
+
+        document.build_indexes();
+        a.expect(document.has_indexes());
+
+        auto check = [&a](dom::Document const &d) {
+            a.expect_eq(d.elements_by_tag("html").size(), std::size_t{1});
+            a.expect_eq(d.elements_by_tag("html")[0], &d.html());
+            a.expect_eq(d.element_by_id("b"), &std::get<dom::Element>(d.html().children.at(0)));
+            a.expect_eq(d.elements_with_attribute("id").size(), std::size_t{1});
+        };
+
+        dom::Document moved{std::move(document)};
+        check(moved);
+
+        dom::Document assigned;
+        assigned = std::move(moved);
+        check(assigned);
+
+        auto const copy = assigned;
+        check(copy);
+
+        // Unindexed documents stay that way.
+        a.expect(!dom::Document{dom::Document{}}.has_indexes());
+    });
+
     return s.run();
 }
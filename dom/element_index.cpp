@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/element_index.h"
+
+#include "dom/atom.h"
+#include "dom/dom.h"
+
+#include "util/string.h"
+
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace dom {
+namespace {
+
+template<typename Map, typename Key>
+std::span<Element const *const> lookup(Map const &map, Key const &key) {
+    if (auto it = map.find(key); it != map.end()) {
+        return it->second;
+    }
+
+    return {};
+}
+
+} // namespace
+
+void ElementIndex::build(Element const &root) {
+    clear();
+    built_ = true;
+
+    std::vector<Element const *> to_visit{&root};
+    while (!to_visit.empty()) {
+        auto const *element = to_visit.back();
+        to_visit.pop_back();
+
+        tags_[element->name].push_back(element);
+
+        for (auto const &[name, value] : element->attributes) {
+            attributes_[name].push_back(element);
+
+            if (name == Atom::known("id")) {
+                // Only the first element with an id is reachable through it.
+                ids_.try_emplace(value, element);
+            } else if (name == Atom::known("class")) {
+                // https://dom.spec.whatwg.org/#concept-ordered-set-parser
+                util::for_each_ascii_whitespace_split(value, [&](std::string_view class_name) {
+                    auto it = classes_.find(class_name);
+                    if (it == classes_.end()) {
+                        it = classes_.emplace(std::string{class_name}, std::vector<Element const *>{}).first;
+                    }
+
+                    // class="a a" is still only one element with the class a.
+                    if (it->second.empty() || it->second.back() != element) {
+                        it->second.push_back(element);
+                    }
+                });
+            }
+        }
+
+        for (auto const &child : element->children | std::views::reverse) {
+            if (auto const *child_element = std::get_if<Element>(&child)) {
+                to_visit.push_back(child_element);
+            }
+        }
+    }
+}
+
+void ElementIndex::clear() {
+    built_ = false;
+    ids_.clear();
+    classes_.clear();
+    tags_.clear();
+    attributes_.clear();
+}
+
+void ElementIndex::rebase(Element const *from, Element const *to) noexcept {
+    for (auto &[id, element] : ids_) {
+        if (element == from) {
+            element = to;
+        }
+    }
+
+    // The root is first in tree order, so it's only ever at the front.
+    auto rebase_front = [&](auto &map) {
+        for (auto &elements : map | std::views::values) {
+            if (elements.front() == from) {
+                elements.front() = to;
+            }
+        }
+    };
+
+    rebase_front(classes_);
+    rebase_front(tags_);
+    rebase_front(attributes_);
+}
+
+Element const *ElementIndex::by_id(std::string_view id) const {
+    auto it = ids_.find(id);
+    return it != ids_.end() ? it->second : nullptr;
+}
+
+std::span<Element const *const> ElementIndex::by_tag(Atom name) const {
+    return lookup(tags_, name);
+}
+
+std::span<Element const *const> ElementIndex::by_class(std::string_view class_name) const {
+    return lookup(classes_, class_name);
+}
+
+std::span<Element const *const> ElementIndex::with_attribute(Atom name) const {
+    return lookup(attributes_, name);
+}
+
+} // namespace dom
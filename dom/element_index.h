@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef DOM_ELEMENT_INDEX_H_
+#define DOM_ELEMENT_INDEX_H_
+
+#include "dom/atom.h"
+
+#include "util/string.h"
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dom {
+
+struct Element;
+
+// Lookup tables from ids, class names, tag names, and attribute names to the
+// elements in a tree, so that finding e.g. all <link> elements doesn't require
+// walking the whole tree.
+//
+// The index points into the tree it was built from, and isn't updated when the
+// tree changes, so it has to be rebuilt after any change to the tree.
+class ElementIndex {
+public:
+    void build(Element const &root);
+    void clear();
+    [[nodiscard]] bool is_built() const { return built_; }
+
+    // Points everything that pointed to `from` to `to` instead, for when the
+    // root of the indexed tree is moved. Its descendants don't move with it.
+    void rebase(Element const *from, Element const *to) noexcept;
+
+    // The first element with this id, in tree order.
+    [[nodiscard]] Element const *by_id(std::string_view) const;
+
+    // All elements matching, in tree order.
+    [[nodiscard]] std::span<Element const *const> by_tag(Atom) const;
+    [[nodiscard]] std::span<Element const *const> by_class(std::string_view) const;
+    [[nodiscard]] std::span<Element const *const> with_attribute(Atom) const;
+
+private:
+    template<typename T>
+    using StringMap = std::unordered_map<std::string, T, util::TransparentStringHash, std::equal_to<>>;
+
+    bool built_{false};
+    StringMap<Element const *> ids_;
+    StringMap<std::vector<Element const *>> classes_;
+    std::unordered_map<Atom, std::vector<Element const *>> tags_;
+    std::unordered_map<Atom, std::vector<Element const *>> attributes_;
+};
+
+} // namespace dom
+
+#endif
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/element_index.h"
+
+#include "dom/dom.h"
+
+#include "etest/etest2.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <variant>
+
+namespace {
+dom::Element const &child(dom::Element const &e, std::size_t i) {
+    return std::get<dom::Element>(e.children.at(i));
+}
+
+bool is(std::span<dom::Element const *const> elements, std::initializer_list<dom::Element const *> expected) {
+    return std::ranges::equal(elements, expected);
+}
+} // namespace
+
+int main() {
+    etest::Suite s{"ElementIndex"};
+
+    // <html><div id=a class=x><p class="x y"></div><p id=a class="  y  y "></html>
+    dom::Element const html{
+            .name{"html"},
+            .children{
+                    dom::Element{
+                            .name{"div"},
+                            .attributes{{"id", "a"}, {"class", "x"}},
+                            .children{dom::Element{.name{"p"}, .attributes{{"class", "x\ty"}}}},
+                    },
+                    dom::Text{"hello"},
+                    dom::Element{.name{"p"}, .attributes{{"id", "a"}, {"class", "  y  y "}}},
+            },
+    };
+    auto const &div = child(html, 0);
+    auto const &inner_p = child(div, 0);
+    auto const &outer_p = child(html, 2);
+
+    s.add_test("empty", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        a.expect(!index.is_built());
+        a.expect_eq(index.by_id("a"), nullptr);
+        a.expect(index.by_tag("p").empty());
+        a.expect(index.by_class("x").empty());
+        a.expect(index.with_attribute("id").empty());
+    });
+
+    s.add_test("by id", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        index.build(html);
+        a.expect(index.is_built());
+        a.expect_eq(index.by_id("a"), &div);
+        a.expect_eq(index.by_id("b"), nullptr);
+    });
+
+    s.add_test("by tag", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        index.build(html);
+        a.expect(is(index.by_tag("html"), {&html}));
+        a.expect(is(index.by_tag("div"), {&div}));
+        a.expect(is(index.by_tag("p"), {&inner_p, &outer_p}));
+        a.expect(index.by_tag("span").empty());
+    });
+
+    s.add_test("by class", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        index.build(html);
+        a.expect(is(index.by_class("x"), {&div, &inner_p}));
+        a.expect(is(index.by_class("y"), {&inner_p, &outer_p}));
+        a.expect(index.by_class("").empty());
+        a.expect(index.by_class("x y").empty());
+    });
+
+    s.add_test("with attribute", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        index.build(html);
+        a.expect(is(index.with_attribute("id"), {&div, &outer_p}));
+        a.expect(is(index.with_attribute("class"), {&div, &inner_p, &outer_p}));
+        a.expect(index.with_attribute("href").empty());
+    });
+
+    s.add_test("rebuild and clear", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        index.build(html);
+        index.build(div);
+        a.expect(is(index.by_tag("p"), {&inner_p}));
+        a.expect(index.by_tag("html").empty());
+
+        index.clear();
+        a.expect(!index.is_built());
+        a.expect(index.by_tag("p").empty());
+    });
+
+    s.add_test("rebase", [&](etest::IActions &a) {
+        dom::ElementIndex index;
+        index.build(div);
+
+        dom::Element const other{};
+        index.rebase(&div, &other);
+        a.expect_eq(index.by_id("a"), &other);
+        a.expect(is(index.by_tag("div"), {&other}));
+        a.expect(is(index.by_class("x"), {&other, &inner_p}));
+        a.expect(is(index.by_tag("p"), {&inner_p}));
+    });
+
+    return s.run();
+}
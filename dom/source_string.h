@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef DOM_SOURCE_STRING_H_
+#define DOM_SOURCE_STRING_H_
+
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace dom {
+
+// Text that's either owned, or a view into the source of the document it's
+// part of. Most text in a document is a byte-for-byte copy of a slice of the
+// source, so if the document keeps its source around, that text doesn't need
+// its own copy. Anything that differs from the source, e.g. due to character
+// references, is owned.
+//
+// The interface is the subset of std::string's used for text.
+class SourceString {
+public:
+    SourceString() = default;
+    // NOLINTBEGIN(google-explicit-constructor): Used in place of strings.
+    SourceString(std::string text) : text_{std::move(text)} {}
+    SourceString(char const *text) : text_{std::string{text}} {}
+    operator std::string_view() const { return str(); }
+    // NOLINTEND(google-explicit-constructor)
+
+    // The text isn't copied, so it has to outlive the string.
+    [[nodiscard]] static SourceString borrowed(std::string_view text) {
+        SourceString s;
+        s.text_ = text;
+        return s;
+    }
+
+    [[nodiscard]] std::string_view str() const {
+        return std::visit([](auto const &text) { return std::string_view{text}; }, text_);
+    }
+
+    [[nodiscard]] bool is_borrowed() const { return std::holds_alternative<std::string_view>(text_); }
+    [[nodiscard]] bool empty() const { return str().empty(); }
+    [[nodiscard]] std::size_t size() const { return str().size(); }
+
+    SourceString &operator+=(char c) {
+        owned() += c;
+        return *this;
+    }
+
+    SourceString &operator+=(std::string_view text) {
+        owned() += text;
+        return *this;
+    }
+
+    // Appends text that has to outlive the string, only copying it if it
+    // doesn't continue where the current text ends.
+    void append_borrowed(std::string_view text) {
+        if (empty()) {
+            text_ = text;
+            return;
+        }
+
+        if (auto *view = std::get_if<std::string_view>(&text_);
+                view != nullptr && view->data() + view->size() == text.data()) {
+            *view = std::string_view{view->data(), view->size() + text.size()};
+            return;
+        }
+
+        *this += text;
+    }
+
+    [[nodiscard]] bool operator==(SourceString const &other) const { return str() == other.str(); }
+
+    template<typename T>
+    requires(std::convertible_to<T const &, std::string_view> && !std::same_as<T, SourceString>)
+    [[nodiscard]] bool operator==(T const &other) const {
+        return str() == std::string_view{other};
+    }
+
+private:
+    std::string &owned() {
+        if (auto const *view = std::get_if<std::string_view>(&text_)) {
+            text_ = std::string{*view};
+        }
+
+        return std::get<std::string>(text_);
+    }
+
+    std::variant<std::string, std::string_view> text_;
+};
+
+inline std::string to_string(SourceString const &s) {
+    return std::string{s.str()};
+}
+
+} // namespace dom
+
+#endif
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/source_string.h"
+
+#include "etest/etest2.h"
+
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("owned", [](etest::IActions &a) {
+        dom::SourceString str{"hello"};
+        a.expect(!str.is_borrowed());
+        a.expect_eq(str.size(), std::size_t{5});
+
+        str += ' ';
+        str += "world"sv;
+        a.expect_eq(str, "hello world");
+        a.expect_eq(str, dom::SourceString{"hello world"s});
+        a.expect(dom::SourceString{}.empty());
+    });
+
+    s.add_test("borrowed", [](etest::IActions &a) {
+        auto const source = "hello world"s;
+        auto const view = std::string_view{source};
+
+        auto str = dom::SourceString::borrowed(view.substr(0, 5));
+        a.expect(str.is_borrowed());
+        a.expect_eq(str.str().data(), source.data());
+
+        // Text continuing where the string ends is still borrowed.
+        str.append_borrowed(view.substr(5, 3));
+        a.expect(str.is_borrowed());
+        a.expect_eq(str, "hello wo");
+
+        // Text from anywhere else isn't.
+        str.append_borrowed(view.substr(0, 1));
+        a.expect(!str.is_borrowed());
+        a.expect_eq(str, "hello woh");
+    });
+
+    s.add_test("appending to borrowed text copies it", [](etest::IActions &a) {
+        auto const source = "hello"s;
+        dom::SourceString str;
+        str.append_borrowed(source);
+        a.expect(str.is_borrowed());
+
+        str += '!';
+        a.expect(!str.is_borrowed());
+        a.expect_eq(str, "hello!");
+        a.expect_eq(source, "hello");
+    });
+
+    s.add_test("comparison", [](etest::IActions &a) {
+        auto const source = "abc"s;
+        a.expect_eq(dom::SourceString::borrowed(source), dom::SourceString{"abc"});
+        a.expect(dom::SourceString::borrowed(source) != dom::SourceString{"abd"});
+        a.expect(dom::SourceString{"abc"} == "abc"sv);
+        a.expect(dom::SourceString{"abc"} != "ab"s);
+    });
+
+    return s.run();
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "dom/xpath.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dom {
+
+std::optional<XPath> XPath::parse(std::string_view xpath) {
+    std::vector<std::vector<Step>> paths{{}};
+    while (true) {
+        auto &path = paths.back();
+
+        Axis axis{};
+        if (xpath.starts_with("//")) {
+            axis = Axis::Descendant;
+            xpath.remove_prefix(2);
+        } else if (xpath.starts_with('/')) {
+            axis = Axis::Child;
+            xpath.remove_prefix(1);
+        } else {
+            return std::nullopt;
+        }
+
+        auto name_end = xpath.find_first_of("/|");
+        auto name = xpath.substr(0, name_end);
+        if (name.empty() || path.size() == kMaxSteps) {
+            return std::nullopt;
+        }
+
+        path.push_back({axis, std::string{name}});
+        if (name_end == std::string_view::npos) {
+            break;
+        }
+
+        xpath.remove_prefix(name_end);
+        if (xpath.starts_with('|')) {
+            xpath.remove_prefix(1);
+            paths.emplace_back();
+        }
+    }
+
+    return XPath{std::move(paths)};
+}
+
+} // namespace dom
@@ -1,4 +1,4 @@
-// SPDX-FileCopyrightText: 2021-2024 Robin Lindén <dev@robinlinden.eu>
+// SPDX-FileCopyrightText: 2021-2025 Robin Lindén <dev@robinlinden.eu>
 //
 // SPDX-License-Identifier: BSD-2-Clause
 
@@ -7,93 +7,150 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <iterator>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace dom {
 
 // https://developer.mozilla.org/en-US/docs/Web/XML/XPath
 // https://en.wikipedia.org/wiki/XPath
-template<typename T>
-inline std::vector<T const *> nodes_by_xpath(T const &root, std::string_view xpath) {
-    std::vector<T const *> next_search{&root};
-    std::vector<T const *> searching{};
-    std::vector<T const *> goal_nodes{};
-
-    // We only support xpaths in the form /a/b/c right now.
-    if (!xpath.starts_with('/')) {
-        return {};
-    }
-
-    static constexpr std::string_view kSeparators{"|/"};
-    auto is_separator = [](char c) {
-        return kSeparators.contains(c);
+//
+// A parsed xpath, for xpaths that are used more than once. Only paths in the
+// form /a//b/c are supported, optionally combined using the union operator.
+//
+// Works on any tree where dom_name(T const &) and dom_children(T const &) are
+// available for the nodes.
+class XPath {
+public:
+    enum class Axis : std::uint8_t {
+        Child,
+        Descendant,
     };
 
-    auto remove_name_segment = [&] {
-        std::size_t separator_position{xpath.find_first_of(kSeparators)};
-        if (separator_position == std::string_view::npos) {
-            xpath = std::string_view{};
-            return;
-        }
-        xpath.remove_prefix(separator_position);
+    struct Step {
+        Axis axis{};
+        std::string name;
+        [[nodiscard]] bool operator==(Step const &) const = default;
     };
 
-    auto search_children = [&] {
-        xpath.remove_prefix(1);
-        for (auto const *node : searching) {
-            auto name = dom_name(*node);
-            if (xpath.substr(0, xpath.find_first_of('|')) == name) {
-                goal_nodes.push_back(node);
-                continue;
-            }
+    // Each path can be at most this many steps long.
+    static constexpr std::size_t kMaxSteps = 63;
+
+    [[nodiscard]] static std::optional<XPath> parse(std::string_view);
+
+    // The matching nodes of each path in the union, in tree order, with nodes
+    // already matched by an earlier path skipped.
+    template<typename T>
+    [[nodiscard]] std::vector<T const *> evaluate(T const &root) const {
+        std::vector<T const *> matches;
+        if (paths_.size() == 1) {
+            evaluate_path(root, paths_[0], matches);
+            return matches;
+        }
 
-            if (xpath.starts_with(name) && xpath.size() >= name.size() + 1 && is_separator(xpath[name.size()])) {
-                for (auto const *child : dom_children(*node)) {
-                    next_search.push_back(child);
+        std::vector<T const *> path_matches;
+        std::unordered_set<T const *> seen;
+        for (auto const &path : paths_) {
+            path_matches.clear();
+            evaluate_path(root, path, path_matches);
+            for (auto const *node : path_matches) {
+                if (seen.insert(node).second) {
+                    matches.push_back(node);
                 }
             }
         }
-    };
 
-    auto search_descendants = [&] {
-        xpath.remove_prefix(2);
-        for (std::size_t i = 0; i < searching.size(); ++i) {
-            auto const *node = searching[i];
+        return matches;
+    }
+
+    [[nodiscard]] std::span<std::vector<Step> const> paths() const { return paths_; }
+    [[nodiscard]] bool operator==(XPath const &) const = default;
+
+private:
+    explicit XPath(std::vector<std::vector<Step>> paths) : paths_{std::move(paths)} {}
+
+    // Visits every node at most once, and skips subtrees no step could match in.
+    //
+    // For each node, we track which steps its parent matched, and which steps
+    // any of its ancestors matched. A node matches step i if it has the right
+    // name, and its parent (for the child axis) or any ancestor (for the
+    // descendant axis) matched step i - 1. Bit i + 1 in the masks is step i,
+    // and bit 0 is the document the root is a child of.
+    template<typename T>
+    static void evaluate_path(T const &root, std::span<Step const> steps, std::vector<T const *> &matches) {
+        std::uint64_t child_steps{};
+        std::uint64_t descendant_steps{};
+        for (std::size_t i = 0; i < steps.size(); ++i) {
+            (steps[i].axis == Axis::Child ? child_steps : descendant_steps) |= std::uint64_t{1} << i;
+        }
+
+        auto const goal = std::uint64_t{1} << steps.size();
+
+        struct Visit {
+            T const *node{};
+            std::uint64_t parent{};
+            std::uint64_t ancestors{};
+        };
+
+        std::vector<Visit> to_visit{{&root, 1, 1}};
+        while (!to_visit.empty()) {
+            auto [node, parent, ancestors] = to_visit.back();
+            to_visit.pop_back();
 
+            std::uint64_t matched{};
             auto name = dom_name(*node);
-            if (xpath.substr(0, xpath.find_first_of('|')) == name) {
-                // TODO(robinlinden): Less terrible way of deduplicating goal nodes.
-                if (std::ranges::find(goal_nodes, node) == end(goal_nodes)) {
-                    goal_nodes.push_back(node);
+            for (std::size_t i = 0; i < steps.size(); ++i) {
+                auto const step = std::uint64_t{1} << i;
+                auto const context = steps[i].axis == Axis::Child ? parent : ancestors;
+                if ((context & step) != 0 && steps[i].name == name) {
+                    matched |= step << 1;
                 }
-            } else if (xpath.starts_with(name) && xpath.size() >= name.size() + 1 && is_separator(xpath[name.size()])) {
-                std::ranges::move(dom_children(*node), std::back_inserter(next_search));
             }
 
-            // Pretty gross, but we want to perform the search in tree order.
-            std::ranges::move(dom_children(*node), std::insert_iterator(searching, next(begin(searching), i + 1)));
-        }
-    };
+            if ((matched & goal) != 0) {
+                matches.push_back(node);
+            }
 
-    while (!next_search.empty() && !xpath.empty()) {
-        searching.swap(next_search);
-        next_search.clear();
-        if (xpath.starts_with("//")) {
-            search_descendants();
-        } else if (xpath.starts_with('/')) {
-            search_children();
-        }
-        remove_name_segment();
+            auto const child_parent = matched & child_steps;
+            auto const child_ancestors = (ancestors | matched) & descendant_steps;
+            if (child_parent == 0 && child_ancestors == 0) {
+                continue;
+            }
 
-        if (xpath.starts_with('|')) {
-            next_search = {&root};
-            xpath.remove_prefix(1);
+            // Reversed once pushed so that they're popped in tree order, as
+            // dom_children may be a range that can't be iterated in reverse.
+            auto const first_child = to_visit.size();
+            for (auto const *child : dom_children(*node)) {
+                to_visit.push_back({child, child_parent, child_ancestors});
+            }
+            std::reverse(to_visit.begin() + static_cast<std::ptrdiff_t>(first_child), to_visit.end());
         }
     }
 
-    return goal_nodes;
+    std::vector<std::vector<Step>> paths_;
+};
+
+template<typename T>
+inline std::vector<T const *> nodes_by_xpath(T const &root, XPath const &xpath) {
+    return xpath.evaluate(root);
+}
+
+// Parses the xpath on every call, so prefer keeping an XPath around for
+// anything that's run more than once.
+template<typename T>
+inline std::vector<T const *> nodes_by_xpath(T const &root, std::string_view xpath) {
+    auto parsed = XPath::parse(xpath);
+    if (!parsed) {
+        return {};
+    }
+
+    return parsed->evaluate(root);
 }
 
 } // namespace dom
@@ -1,4 +1,4 @@
-// SPDX-FileCopyrightText: 2021-2024 Robin Lindén <dev@robinlinden.eu>
+// SPDX-FileCopyrightText: 2021-2025 Robin Lindén <dev@robinlinden.eu>
 //
 // SPDX-License-Identifier: BSD-2-Clause
 
@@ -8,6 +8,8 @@
 
 #include "etest/etest2.h"
 
+#include <cstddef>
+#include <string>
 #include <vector>
 
 using dom::Element;
@@ -94,6 +96,70 @@ void union_operator_tests(etest::Suite &s) {
 
         auto nodes = nodes_by_xpath(div, "/div/p|//span");
         a.expect_eq(nodes, std::vector{&p, &div_first_span, &p_span, &div_last_span});
+
+        // Nodes matched by an earlier path aren't repeated.
+        nodes = nodes_by_xpath(div, "//p/span|//span|/div/p");
+        a.expect_eq(nodes, std::vector{&p_span, &div_first_span, &div_last_span, &p});
+    });
+}
+
+void parse_tests(etest::Suite &s) {
+    using Axis = dom::XPath::Axis;
+    using Step = dom::XPath::Step;
+    using Path = std::vector<Step>;
+
+    s.add_test("parse", [](etest::IActions &a) {
+        auto xpath = dom::XPath::parse("/html//div/p|//a");
+        a.require(xpath.has_value());
+        a.require(xpath->paths().size() == 2);
+        a.expect(xpath->paths()[0]
+                == Path{{Axis::Child, "html"}, {Axis::Descendant, "div"}, {Axis::Child, "p"}});
+        a.expect(xpath->paths()[1] == Path{{Axis::Descendant, "a"}});
+    });
+
+    s.add_test("parse, invalid", [](etest::IActions &a) {
+        a.expect(!dom::XPath::parse("").has_value());
+        a.expect(!dom::XPath::parse("div").has_value());
+        a.expect(!dom::XPath::parse("/").has_value());
+        a.expect(!dom::XPath::parse("/div/").has_value());
+        a.expect(!dom::XPath::parse("/div//").has_value());
+        a.expect(!dom::XPath::parse("///div").has_value());
+        a.expect(!dom::XPath::parse("/div|").has_value());
+        a.expect(!dom::XPath::parse("/div|p").has_value());
+    });
+
+    s.add_test("parse, too many steps", [](etest::IActions &a) {
+        std::string xpath;
+        for (std::size_t i = 0; i < dom::XPath::kMaxSteps; ++i) {
+            xpath += "/a";
+        }
+
+        a.expect(dom::XPath::parse(xpath).has_value());
+        a.expect(!dom::XPath::parse(xpath + "/a").has_value());
+        a.expect(dom::XPath::parse(xpath + "|" + xpath).has_value());
+    });
+
+    s.add_test("reusing a parsed xpath", [](etest::IActions &a) {
+        auto const xpath = *dom::XPath::parse("/html/body/p");
+        dom::Element const first{"html", {}, {dom::Element{"body", {}, {dom::Element{"p"}}}}};
+        dom::Element const second{"html", {}, {dom::Element{"body", {}, {dom::Element{"p"}, dom::Element{"p"}}}}};
+
+        a.expect_eq(nodes_by_xpath(first, xpath).size(), std::size_t{1});
+        a.expect_eq(nodes_by_xpath(second, xpath).size(), std::size_t{2});
+        a.expect_eq(nodes_by_xpath(first, xpath).size(), std::size_t{1});
+    });
+
+    s.add_test("deep trees", [](etest::IActions &a) {
+        dom::Element root{"div"};
+        auto *current = &root;
+        for (int i = 0; i < 10'000; ++i) {
+            current = &std::get<dom::Element>(current->children.emplace_back(dom::Element{"div"}));
+        }
+
+        a.expect_eq(nodes_by_xpath(root, "//div").size(), std::size_t{10'001});
+        a.expect_eq(nodes_by_xpath(root, "//div//div").size(), std::size_t{10'000});
+        a.expect_eq(nodes_by_xpath(root, "/div/div/div").size(), std::size_t{1});
+        a.expect_eq(nodes_by_xpath(root, "//div").back(), current);
     });
 }
 
@@ -104,6 +170,7 @@ int main() {
 
     descendant_axis_tests(s);
     union_operator_tests(s);
+    parse_tests(s);
 
     s.add_test("unsupported xpaths don't return anything", [](etest::IActions &a) {
         dom::Element dom = dom::Element{"div"};
@@ -11,11 +11,13 @@
 #include "css/media_query.h"
 #include "css/parser.h"
 #include "css/style_sheet.h"
+#include "dom/atom.h"
 #include "dom/dom.h"
 #include "dom/xpath.h"
 #include "html/parser.h"
 #include "html2/tokenizer.h"
 #include "layout/layout.h"
+#include "protocol/dictionary_store.h"
 #include "protocol/response.h"
 #include "style/style.h"
 #include "uri/uri.h"
@@ -23,7 +25,10 @@
 #include <spdlog/spdlog.h>
 #include <tl/expected.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <future>
 #include <memory>
 #include <span>
@@ -37,15 +42,58 @@ using namespace std::literals;
 namespace engine {
 namespace {
 
+// https://www.rfc-editor.org/rfc/rfc9842#name-dictionary-compressed-brotli
+constexpr auto kDcbHeaderMagic = std::to_array<std::uint8_t>({0xff, 0x44, 0x43, 0x42});
+// https://www.rfc-editor.org/rfc/rfc9842#name-dictionary-compressed-zstand
+constexpr auto kDczHeaderMagic = std::to_array<std::uint8_t>({0x5e, 0x2a, 0x4d, 0x18, 0x20, 0x00, 0x00, 0x00});
+
+std::span<std::byte const> as_bytes(std::string const &s) {
+    return {reinterpret_cast<std::byte const *>(s.data()), s.size()};
+}
+
+// Removes the dcb or dcz header, the magic followed by the SHA-256 hash of the
+// dictionary, from the body and returns the dictionary it refers to if that's
+// the one advertised when requesting the uri.
+std::shared_ptr<protocol::SharedDictionary const> take_dictionary(uri::Uri const &uri,
+        std::span<std::byte const> &body,
+        std::span<std::uint8_t const> magic,
+        protocol::DictionaryStore const &dictionaries) {
+    static constexpr std::size_t kHashSize = 32;
+    if (body.size() < magic.size() + kHashSize
+            || !std::ranges::equal(body.first(magic.size()), magic, {}, {}, [](auto b) { return std::byte{b}; })) {
+        return nullptr;
+    }
+
+    std::array<std::uint8_t, kHashSize> hash{};
+    std::ranges::transform(body.subspan(magic.size(), kHashSize), hash.begin(), [](auto b) {
+        return std::to_integer<std::uint8_t>(b);
+    });
+    body = body.subspan(magic.size() + kHashSize);
+    return dictionaries.find(uri, hash);
+}
+
 // https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Content-Encoding#directives
-[[nodiscard]] bool try_decompress_response_body(uri::Uri const &uri, protocol::Response &response) {
+[[nodiscard]] bool try_decompress_response_body(
+        uri::Uri const &uri, protocol::Response &response, protocol::DictionaryStore const *dictionaries) {
     auto encoding = response.headers.get("Content-Encoding");
     if (!encoding) {
         return true;
     }
 
-    std::span<std::byte const> body_view{
-            reinterpret_cast<std::byte const *>(response.body.data()), response.body.size()};
+    std::span<std::byte const> body_view = as_bytes(response.body);
+
+    std::shared_ptr<protocol::SharedDictionary const> dictionary;
+    if (encoding == "dcb" || encoding == "dcz") {
+        auto magic = encoding == "dcb" ? std::span<std::uint8_t const>{kDcbHeaderMagic} : kDczHeaderMagic;
+        if (dictionaries != nullptr) {
+            dictionary = take_dictionary(uri, body_view, magic, *dictionaries);
+        }
+
+        if (!dictionary) {
+            spdlog::error("Failed {}-decoding of '{}': no matching dictionary", *encoding, uri.uri);
+            return false;
+        }
+    }
 
     if (encoding == "gzip" || encoding == "x-gzip" || encoding == "deflate") {
         auto zlib_mode = encoding == "deflate" ? archive::ZlibMode::Zlib : archive::ZlibMode::Gzip;
@@ -60,8 +108,13 @@ namespace {
         return true;
     }
 
-    if (encoding == "zstd") {
-        auto decoded = archive::zstd_decode(body_view);
+    if (encoding == "zstd" || encoding == "dcz") {
+        archive::ZstdDecoder decoder;
+        if (dictionary) {
+            decoder.set_dictionary(as_bytes(dictionary->data));
+        }
+
+        auto decoded = decoder.decode(body_view);
         if (!decoded) {
             auto const &err = decoded.error();
             spdlog::error(
@@ -73,8 +126,13 @@ namespace {
         return true;
     }
 
-    if (encoding == "br") {
-        auto decoded = archive::brotli_decode(body_view);
+    if (encoding == "br" || encoding == "dcb") {
+        archive::BrotliDecoder decoder;
+        if (dictionary) {
+            decoder.set_dictionary(as_bytes(dictionary->data));
+        }
+
+        auto decoded = decoder.decode(body_view);
         if (!decoded) {
             auto const &err = decoded.error();
             spdlog::error(
@@ -102,7 +160,7 @@ css::MediaQuery::Context to_media_context(Options opts) {
 
 tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::Uri uri, Options opts) {
     spdlog::info("Navigating to {}", uri.uri);
-    auto result = load(std::move(uri));
+    auto result = load(std::move(uri), "document");
 
     if (!result.response.has_value()) {
         return tl::unexpected{NavigationError{
@@ -111,7 +169,7 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
         }};
     }
 
-    if (!try_decompress_response_body(result.uri_after_redirects, *result.response)) {
+    if (!try_decompress_response_body(result.uri_after_redirects, *result.response, dictionaries_.get())) {
         return tl::unexpected{NavigationError{
                 .uri = std::move(result.uri_after_redirects),
                 .response{protocol::Error{
@@ -121,16 +179,25 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
         }};
     }
 
+    if (dictionaries_) {
+        dictionaries_->add(result.uri_after_redirects, *result.response);
+    }
+
     auto state = std::make_unique<PageState>();
     state->uri = std::move(result.uri_after_redirects);
-    state->response = std::move(result.response.value());
+    state->status_line = std::move(result.response->status_line);
+    state->headers = std::move(result.response->headers);
     spdlog::info("Parsing HTML");
+    // The document keeps the body alive so that its text can refer to it
+    // instead of every text node owning a copy.
+    auto body = std::make_shared<std::string const>(std::move(result.response->body));
     state->dom = html::parse(
-            state->response.body, {}, [](html2::ParseError e) { spdlog::warn("HTML parse error: {}", to_string(e)); });
+            std::move(body), {}, [](html2::ParseError e) { spdlog::warn("HTML parse error: {}", to_string(e)); });
 
     spdlog::info("Parsing inline styles");
     state->stylesheet = css::default_style();
-    for (auto const &style : dom::nodes_by_xpath(state->dom.html(), "/html/head/style"sv)) {
+    static auto const kHeadStyles = *dom::XPath::parse("/html/head/style");
+    for (auto const &style : dom::nodes_by_xpath(state->dom.html(), kHeadStyles)) {
         if (style->children.empty()) {
             continue;
         }
@@ -142,7 +209,8 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
 
     // Stylesheets can appear a bit everywhere:
     // https://html.spec.whatwg.org/multipage/semantics.html#allowed-in-the-body
-    auto head_links = dom::nodes_by_xpath(state->dom.html(), "//link");
+    auto const links = state->dom.elements_by_tag(dom::Atom::known("link"));
+    std::vector<dom::Element const *> head_links{links.begin(), links.end()};
     std::erase_if(head_links, [](auto const *link) {
         return !link->attributes.contains("rel")
                 || (link->attributes.contains("rel") && link->attributes.at("rel") != "stylesheet")
@@ -163,7 +231,7 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
             }
 
             spdlog::info("Downloading stylesheet from {}", stylesheet_url->uri);
-            auto res = load(*stylesheet_url);
+            auto res = load(*stylesheet_url, "style");
             auto &style_data = res.response;
             stylesheet_url = std::move(res.uri_after_redirects);
 
@@ -181,10 +249,14 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
                 return {};
             }
 
-            if (!try_decompress_response_body(*stylesheet_url, *style_data)) {
+            if (!try_decompress_response_body(*stylesheet_url, *style_data, dictionaries_.get())) {
                 return {};
             }
 
+            if (dictionaries_) {
+                dictionaries_->add(*stylesheet_url, *style_data);
+            }
+
             return css::parse(style_data->body);
         }));
     }
@@ -197,7 +269,8 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
     spdlog::info("Styling dom w/ {} rules", state->stylesheet.rules.size());
     state->layout_width = opts.layout_width;
     state->viewport_height = opts.viewport_height;
-    state->styled = style::style_tree(state->dom.html_node, state->stylesheet, to_media_context(opts));
+    state->styled = style::style_tree(
+            state->dom.html_node, state->stylesheet, to_media_context(opts), opts.style_threads);
     spdlog::info("Building layout");
     state->layout = layout::create_layout(*state->styled,
             {state->layout_width, state->viewport_height},
@@ -211,14 +284,15 @@ tl::expected<std::unique_ptr<PageState>, NavigationError> Engine::navigate(uri::
 void Engine::relayout(PageState &state, Options opts) {
     state.layout_width = opts.layout_width;
     state.viewport_height = opts.viewport_height;
-    state.styled = style::style_tree(state.dom.html_node, state.stylesheet, to_media_context(opts));
+    state.styled = style::style_tree(
+            state.dom.html_node, state.stylesheet, to_media_context(opts), opts.style_threads);
     state.layout = layout::create_layout(*state.styled,
             {state.layout_width, state.viewport_height},
             *type_,
             get_intrensic_size_for_resource_at_url_);
 }
 
-Engine::LoadResult Engine::load(uri::Uri uri) {
+Engine::LoadResult Engine::load(uri::Uri uri, std::string_view destination) {
     static constexpr int kMaxRedirects = 10;
 
     auto is_redirect = [](int status_code) {
@@ -226,7 +300,7 @@ Engine::LoadResult Engine::load(uri::Uri uri) {
     };
 
     int redirect_count = 0;
-    auto response = protocol_handler_->handle(uri);
+    auto response = protocol_handler_->handle_for_destination(uri, destination);
     while (response.has_value() && is_redirect(response->status_line.status_code)) {
         ++redirect_count;
         auto location = response->headers.get("Location");
@@ -249,7 +323,7 @@ Engine::LoadResult Engine::load(uri::Uri uri) {
         }
 
         uri = *std::move(new_uri);
-        response = protocol_handler_->handle(uri);
+        response = protocol_handler_->handle_for_destination(uri, destination);
         if (redirect_count > kMaxRedirects) {
             return {
                     .response = tl::unexpected{protocol::Error{
@@ -10,6 +10,7 @@
 #include "dom/dom.h"
 #include "layout/layout.h"
 #include "layout/layout_box.h"
+#include "protocol/dictionary_store.h"
 #include "protocol/iprotocol_handler.h"
 #include "protocol/response.h"
 #include "style/styled_node.h"
@@ -19,6 +20,7 @@
 
 #include <tl/expected.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -32,11 +34,15 @@ struct Options {
     int layout_width{600};
     int viewport_height{800};
     bool dark_mode{false};
+    // The number of threads used for styling the page.
+    std::size_t style_threads{1};
 };
 
 struct PageState {
     uri::Uri uri{};
-    protocol::Response response{};
+    // The response body is owned by the document, see dom::Document::source().
+    protocol::StatusLine status_line{};
+    protocol::Headers headers{};
     dom::Document dom{};
     css::StyleSheet stylesheet{};
     std::unique_ptr<style::StyledNode> styled{};
@@ -69,13 +75,23 @@ public:
         tl::expected<protocol::Response, protocol::Error> response;
         uri::Uri uri_after_redirects;
     };
-    LoadResult load(uri::Uri);
+    // The destination is what's being loaded, e.g. "document" or "image".
+    // https://fetch.spec.whatwg.org/#concept-request-destination
+    LoadResult load(uri::Uri, std::string_view destination = {});
 
     type::IType &font_system() { return *type_; }
 
+    // Enables Compression Dictionary Transport: responses with a
+    // Use-As-Dictionary header are stored as dictionaries, and dcb- and
+    // dcz-encoded responses are decoded using them.
+    void set_dictionary_store(std::shared_ptr<protocol::DictionaryStore> dictionaries) {
+        dictionaries_ = std::move(dictionaries);
+    }
+
 private:
     std::unique_ptr<protocol::IProtocolHandler> protocol_handler_{};
     std::unique_ptr<type::IType> type_{};
+    std::shared_ptr<protocol::DictionaryStore> dictionaries_{};
     std::function<std::optional<layout::Size>(std::string_view)> get_intrensic_size_for_resource_at_url_{};
 };
 
@@ -10,6 +10,7 @@
 #include "dom/xpath.h"
 #include "etest/etest2.h"
 #include "gfx/color.h"
+#include "protocol/dictionary_store.h"
 #include "protocol/iprotocol_handler.h"
 #include "protocol/response.h"
 #include "style/styled_node.h"
@@ -20,11 +21,16 @@
 #include <tl/expected.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
+#include <variant>
 #include <vector>
 
 using namespace std::literals;
@@ -46,6 +52,31 @@ private:
     Responses responses_;
 };
 
+// Records what each uri was requested as.
+class DestinationRecordingProtocolHandler final : public protocol::IProtocolHandler {
+public:
+    using Destinations = std::map<std::string, std::string, std::less<>>;
+
+    DestinationRecordingProtocolHandler(Responses responses, std::shared_ptr<Destinations> destinations)
+        : responses_{std::move(responses)}, destinations_{std::move(destinations)} {}
+
+    [[nodiscard]] tl::expected<Response, protocol::Error> handle(uri::Uri const &uri) override {
+        return handle_for_destination(uri, {});
+    }
+
+    [[nodiscard]] tl::expected<Response, protocol::Error> handle_for_destination(
+            uri::Uri const &uri, std::string_view destination) override {
+        std::scoped_lock lock{mutex_};
+        (*destinations_)[uri.uri] = destination;
+        return responses_.at(uri.uri);
+    }
+
+private:
+    Responses responses_;
+    std::mutex mutex_;
+    std::shared_ptr<Destinations> destinations_;
+};
+
 bool contains(std::vector<css::Rule> const &stylesheet, css::Rule const &rule) {
     return std::ranges::find(stylesheet, rule) != end(stylesheet);
 }
@@ -72,6 +103,26 @@ int main() {
                 });
     });
 
+    s.add_test("text refers to the response body", [](etest::IActions &a) {
+        auto const body = "<html><body><p>hello</p></body></html>"s;
+        Responses responses{{
+                "hax://example.com"s,
+                Response{.status_line = {.status_code = 200}, .body{body}},
+        }};
+        engine::Engine e{std::make_unique<FakeProtocolHandler>(std::move(responses))};
+        auto page = e.navigate(uri::Uri::parse("hax://example.com").value());
+        a.require(page.has_value());
+        a.expect_eq(page.value()->status_line.status_code, 200);
+        a.expect_eq(page.value()->dom.source(), body);
+
+        auto paragraphs = dom::nodes_by_xpath(page.value()->dom.html(), "/html/body/p");
+        a.require_eq(paragraphs.size(), std::size_t{1});
+        auto const &text = std::get<dom::Text>(paragraphs[0]->children.at(0)).text;
+        a.expect_eq(text, "hello");
+        a.expect(text.is_borrowed());
+        a.expect(page.value()->dom.is_source_of(text));
+    });
+
     s.add_test("navigation failure", [](etest::IActions &a) {
         engine::Engine e{std::make_unique<FakeProtocolHandler>(Responses{
                 std::pair{"hax://example.com"s, tl::unexpected{protocol::Error{ErrorCode::Unresolved}}},
@@ -187,6 +238,28 @@ int main() {
         a.expect(contains(page->stylesheet.rules, {.selectors{"a"}, .declarations{{css::PropertyId::Color, "red"}}}));
     });
 
+    s.add_test("request destinations", [](etest::IActions &a) {
+        Responses responses;
+        responses["hax://example.com"s] = Response{
+                .status_line = {.status_code = 200},
+                .body{"<html><head><link rel=stylesheet href=one.css /></head></html>"},
+        };
+        responses["hax://example.com/one.css"s] = Response{.status_line = {.status_code = 200}};
+        responses["hax://example.com/img.png"s] = Response{.status_line = {.status_code = 200}};
+
+        auto destinations = std::make_shared<DestinationRecordingProtocolHandler::Destinations>();
+        engine::Engine e{std::make_unique<DestinationRecordingProtocolHandler>(std::move(responses), destinations)};
+        a.require(e.navigate(uri::Uri::parse("hax://example.com").value()).has_value());
+        std::ignore = e.load(uri::Uri::parse("hax://example.com/img.png").value(), "image");
+
+        a.expect_eq(*destinations,
+                DestinationRecordingProtocolHandler::Destinations{
+                        {"hax://example.com", "document"},
+                        {"hax://example.com/one.css", "style"},
+                        {"hax://example.com/img.png", "image"},
+                });
+    });
+
     s.add_test("stylesheet link, unsupported Content-Encoding", [](etest::IActions &a) {
         Responses responses;
         responses["hax://example.com"s] = Response{
@@ -436,6 +509,54 @@ int main() {
                 }});
     });
 
+    s.add_test("html, dcz-compressed", [](etest::IActions &a) {
+        // zstd --no-check -D dictionary.html page.html
+        auto const dcz_compressed_html = "\x28\xb5\x2f\xfd\x20\x5c\x9d\x00\x00\x50\x64\x69\x63\x74"
+                                         "\x69\x6f\x6e\x61\x72\x79\x02\x00\x5f\xd0\x38\x4d\x0a\x40"s;
+        Responses responses;
+        responses["https://example.com/dictionary.html"s] = Response{
+                .status_line = {.status_code = 200},
+                .headers{{"Use-As-Dictionary", R"(match="/*")"}, {"Cache-Control", "max-age=3600"}},
+                .body{"<html><head><title>Example page</title></head><body><p>Hello, world!</p></body></html>\n"},
+        };
+        responses["https://example.com/page.html"s] = Response{
+                .status_line = {.status_code = 200},
+                .headers{{"Content-Encoding", "dcz"}},
+        };
+
+        auto dictionaries = std::make_shared<protocol::DictionaryStore>();
+        engine::Engine e{std::make_unique<FakeProtocolHandler>(responses)};
+        e.set_dictionary_store(dictionaries);
+
+        // No dictionary available yet.
+        auto page = e.navigate(uri::Uri::parse("https://example.com/page.html").value());
+        a.expect_eq(page.error().response.err, protocol::ErrorCode::InvalidResponse);
+
+        a.require(e.navigate(uri::Uri::parse("https://example.com/dictionary.html").value()).has_value());
+        auto dictionary = dictionaries->find(uri::Uri::parse("https://example.com/page.html").value());
+        a.require(dictionary != nullptr);
+
+        auto &body = responses["https://example.com/page.html"s]->body;
+        body = "\x5e\x2a\x4d\x18\x20\x00\x00\x00"s;
+        body.append(reinterpret_cast<char const *>(dictionary->hash.data()), dictionary->hash.size());
+        body += dcz_compressed_html;
+
+        e = engine::Engine{std::make_unique<FakeProtocolHandler>(responses)};
+        e.set_dictionary_store(dictionaries);
+        page = e.navigate(uri::Uri::parse("https://example.com/page.html").value());
+        a.require(page.has_value());
+        auto paragraphs = dom::nodes_by_xpath(page.value()->dom.html(), "/html/body/p");
+        a.require_eq(paragraphs.size(), std::size_t{1});
+        a.expect_eq(*paragraphs[0], dom::Element{"p", {}, {dom::Text{"Hello, dictionary!"}}});
+
+        // The dictionary isn't available to other origins.
+        responses["https://example.net/page.html"s] = responses["https://example.com/page.html"s];
+        e = engine::Engine{std::make_unique<FakeProtocolHandler>(responses)};
+        e.set_dictionary_store(dictionaries);
+        page = e.navigate(uri::Uri::parse("https://example.net/page.html").value());
+        a.expect_eq(page.error().response.err, protocol::ErrorCode::InvalidResponse);
+    });
+
     s.add_test("html, unhandled content-encoding", [zstd_compressed_html](etest::IActions &a) {
         Responses responses;
         responses["hax://example.com"s] = Response{
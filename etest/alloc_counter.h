@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef ETEST_ALLOC_COUNTER_H_
+#define ETEST_ALLOC_COUNTER_H_
+
+#include <cstddef>
+
+namespace etest {
+
+// The number of heap allocations made so far. Linking this in replaces the
+// global operator new and delete, so it's meant for benchmarks reporting
+// allocations per operation, not for regular tests.
+std::size_t allocation_count();
+
+} // namespace etest
+
+#endif
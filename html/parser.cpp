@@ -1,4 +1,4 @@
-// SPDX-FileCopyrightText: 2021-2024 Robin Lindén <dev@robinlinden.eu>
+// SPDX-FileCopyrightText: 2021-2025 Robin Lindén <dev@robinlinden.eu>
 //
 // SPDX-License-Identifier: BSD-2-Clause
 
@@ -7,14 +7,35 @@
 #include "html2/parser_states.h"
 #include "html2/token.h"
 #include "html2/tokenizer.h"
+#include "html2/tokenizer_impl.h"
 
-#include <variant>
+#include "dom/dom.h"
+
+#include <string_view>
+#include <utility>
+
+template class html2::BasicTokenizer<html::Parser::TokenSink>;
 
 namespace html {
 
-void Parser::on_token(html2::Tokenizer &, html2::Token &&token) {
-    insertion_mode_ = std::visit([&](auto &mode) { return mode.process(actions_, token); }, insertion_mode_)
-                              .value_or(insertion_mode_);
+dom::Document Parser::run() {
+    tokenizer_.run();
+    doc_.build_indexes();
+    return std::move(doc_);
+}
+
+void Parser::feed(std::string_view chunk) {
+    tokenizer_.feed(chunk);
+}
+
+dom::Document Parser::finish() {
+    tokenizer_.finish();
+    doc_.build_indexes();
+    return std::move(doc_);
+}
+
+void Parser::on_token(html2::Token &&token) {
+    html2::process_token(insertion_mode_, actions_, token);
 }
 
 } // namespace html
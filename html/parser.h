@@ -13,6 +13,8 @@
 #include "html2/tokenizer.h"
 
 #include <functional>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -26,42 +28,81 @@ struct ParserOptions {
 class Parser {
 public:
     [[nodiscard]] static dom::Document parse_document(
-            std::string_view input, ParserOptions const &opts, std::function<void(html2::ParseError)> const &on_error) {
-        Parser parser{input, opts, on_error};
+            std::string_view input, ParserOptions const &opts, std::function<void(html2::ParseError)> on_error) {
+        Parser parser{input, opts, std::move(on_error)};
         return parser.run();
     }
 
-private:
-    Parser(std::string_view input, ParserOptions const &opts, std::function<void(html2::ParseError)> const &on_error)
-        : tokenizer_{input,
-                  [this](html2::Tokenizer &tokenizer, html2::Token &&token) { on_token(tokenizer, std::move(token)); },
-                  [&on_error](html2::Tokenizer &, html2::ParseError err) {
-                      on_error(err);
-                  }},
-          scripting_{opts.scripting} {}
-
-    [[nodiscard]] dom::Document run() {
-        tokenizer_.run();
-        return std::move(doc_);
+    // Parses the document, keeping the input alive in it so that text that's
+    // unchanged from the input can refer to it instead of being copied.
+    [[nodiscard]] static dom::Document parse_document(std::shared_ptr<std::string const> input,
+            ParserOptions const &opts,
+            std::function<void(html2::ParseError)> on_error) {
+        Parser parser{*input, opts, std::move(on_error)};
+        parser.doc_.keep_source(std::move(input));
+        return parser.run();
     }
 
-    void on_token(html2::Tokenizer &, html2::Token &&token);
+    // For parsing a document that arrives in chunks, e.g. from the network.
+    explicit Parser(ParserOptions const &opts = {}, std::function<void(html2::ParseError)> on_error = [](auto) {})
+        : Parser{{}, opts, std::move(on_error)} {}
+
+    Parser(Parser const &) = delete;
+    Parser &operator=(Parser const &) = delete;
+
+    // Parses as much of the chunk as possible, keeping anything incomplete,
+    // like half a tag, around until the next chunk arrives.
+    void feed(std::string_view chunk);
+
+    // Parses whatever's left and returns the finished, indexed, document.
+    [[nodiscard]] dom::Document finish();
+
+    // The document as parsed so far. It isn't indexed until it's finished.
+    [[nodiscard]] dom::Document const &document() const { return doc_; }
+
+private:
+    // Hands tokens straight to the parser, letting the tokenizer inline the
+    // token handling instead of going through std::function.
+    struct TokenSink {
+        Parser &parser;
+        void on_token(html2::BasicTokenizer<TokenSink> &, html2::Token &&token) {
+            parser.on_token(std::move(token));
+        }
+        void on_error(html2::BasicTokenizer<TokenSink> &, html2::ParseError error) { parser.on_error_(error); }
+    };
+
+    Parser(std::string_view input, ParserOptions const &opts, std::function<void(html2::ParseError)> on_error)
+        : tokenizer_{input, TokenSink{*this}}, on_error_{std::move(on_error)}, scripting_{opts.scripting} {}
+
+    [[nodiscard]] dom::Document run();
 
-    html2::Tokenizer tokenizer_;
+    void on_token(html2::Token &&token);
+
+    html2::BasicTokenizer<TokenSink> tokenizer_;
+    std::function<void(html2::ParseError)> on_error_;
     dom::Document doc_{};
     std::vector<dom::Element *> open_elements_{};
     bool scripting_{false};
     html2::InsertionMode insertion_mode_{};
-    Actions actions_{doc_, tokenizer_, scripting_, insertion_mode_, open_elements_};
+    Actions<html2::BasicTokenizer<TokenSink>> actions_{doc_, tokenizer_, scripting_, insertion_mode_, open_elements_};
 };
 
 inline dom::Document parse(
         std::string_view input,
         ParserOptions const &opts = {},
-        std::function<void(html2::ParseError)> const &on_error = [](auto) {}) {
-    return Parser::parse_document(input, opts, on_error);
+        std::function<void(html2::ParseError)> on_error = [](auto) {}) {
+    return Parser::parse_document(input, opts, std::move(on_error));
+}
+
+inline dom::Document parse(
+        std::shared_ptr<std::string const> input,
+        ParserOptions const &opts = {},
+        std::function<void(html2::ParseError)> on_error = [](auto) {}) {
+    return Parser::parse_document(std::move(input), opts, std::move(on_error));
 }
 
 } // namespace html
 
+extern template class html2::BasicTokenizer<html::Parser::TokenSink>;
+
 #endif
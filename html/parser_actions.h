@@ -7,6 +7,7 @@
 
 #include "dom/dom.h"
 #include "html2/iparser_actions.h"
+#include "html2/open_elements.h"
 #include "html2/parser_states.h"
 #include "html2/token.h"
 #include "html2/tokenizer.h"
@@ -23,10 +24,12 @@
 
 namespace html {
 
+// Templated on the tokenizer so that it works with any html2::BasicTokenizer.
+template<typename TokenizerT>
 class Actions : public html2::IActions {
 public:
     Actions(dom::Document &document,
-            html2::Tokenizer &tokenizer,
+            TokenizerT &tokenizer,
             bool scripting,
             html2::InsertionMode &current_insertion_mode,
             std::vector<dom::Element *> &open_elements)
@@ -64,19 +67,20 @@ public:
     bool scripting() const override { return scripting_; }
 
     void insert_element_for(html2::StartTagToken const &token) override {
-        auto into_dom_attributes = [](std::vector<html2::Attribute> const &attributes) -> dom::AttrMap {
-            dom::AttrMap attrs{};
-            for (auto const &[name, value] : attributes) {
-                attrs[name] = value;
-            }
+        auto element = document_.create_element(token.tag_name);
+        element.attributes.reserve(token.attributes.size());
+        for (auto const &[name, value] : token.attributes) {
+            element.attributes[name] = value;
+        }
 
-            return attrs;
-        };
+        insert(std::move(element));
+    }
 
-        insert({token.tag_name, into_dom_attributes(token.attributes)});
+    void pop_current_node() override {
+        open_elements_.pop_back();
+        open_element_stack_.pop();
     }
 
-    void pop_current_node() override { open_elements_.pop_back(); }
     std::string_view current_node_name() const override { return open_elements_.back()->name; }
 
     void merge_into_html_node(std::span<html2::Attribute const> attrs) override {
@@ -91,12 +95,17 @@ public:
     }
 
     void insert_character(html2::CharacterToken const &character) override {
-        auto &current_element = open_elements_.back();
-        if (current_element->children.empty() || !std::holds_alternative<dom::Text>(current_element->children.back())) {
-            current_element->children.emplace_back(dom::Text{});
-        }
+        current_text().text += character.data;
+    }
 
-        std::get<dom::Text>(current_element->children.back()).text += character.data;
+    // Runs of characters are views into the tokenizer's input, so if the
+    // document keeps that around, the text doesn't need to be copied.
+    void insert_characters(std::string_view characters) override {
+        if (document_.is_source_of(characters)) {
+            current_text().text.append_borrowed(characters);
+        } else {
+            current_text().text += characters;
+        }
     }
 
     void set_tokenizer_state(html2::State state) override { tokenizer_.set_state(state); }
@@ -115,60 +124,77 @@ public:
 
     void push_head_as_current_open_element() override {
         auto head = std::ranges::find_if(document_.html().children, [](auto const &node) {
-            return std::holds_alternative<dom::Element>(node) && std::get<dom::Element>(node).name == "head";
+            return std::holds_alternative<dom::Element>(node)
+                    && std::get<dom::Element>(node).name == dom::Atom::known("head");
         });
 
         assert(head != document_.html().children.end());
         assert(std::ranges::find(open_elements_, &std::get<dom::Element>(*head)) == open_elements_.end());
 
-        open_elements_.push_back(&std::get<dom::Element>(*head));
+        push(std::get<dom::Element>(*head));
     }
 
+    // The element being removed is almost always the current node, so look
+    // for it starting from the top of the stack.
     void remove_from_open_elements(std::string_view element_name) override {
-        auto const it = std::ranges::find_if(open_elements_, [element_name](auto const &element) {
-            return element->name == element_name; //
+        auto const it = std::ranges::find_if(open_elements_.rbegin(), open_elements_.rend(), [&](auto const &e) {
+            return e->name == element_name; //
         });
 
-        assert(it != open_elements_.end());
-        open_elements_.erase(it);
+        assert(it != open_elements_.rend());
+        open_elements_.erase(std::next(it).base());
+        open_element_stack_.remove(element_name);
     }
 
     void reconstruct_active_formatting_elements() override {
         // TODO(robinlinden): Implement.
     }
 
-    std::vector<std::string_view> names_of_open_elements() const override {
-        std::vector<std::string_view> names;
-        names.reserve(open_elements_.size());
-        std::ranges::transform(open_elements_, std::back_inserter(names), &dom::Element::name);
-        std::ranges::reverse(names);
-        return names;
-    }
+    html2::OpenElementStack const &open_elements() const override { return open_element_stack_; }
 
     void set_foster_parenting(bool) override {
         // TODO(robinlinden): Implement.
     }
 
 private:
+    // The text node at the end of the current element, created if missing.
+    dom::Text &current_text() {
+        auto &current_element = open_elements_.back();
+        if (current_element->children.empty() || !std::holds_alternative<dom::Text>(current_element->children.back())) {
+            current_element->children.emplace_back(dom::Text{});
+        }
+
+        return std::get<dom::Text>(current_element->children.back());
+    }
+
     void insert(dom::Element element) {
-        if (element.name == "html") {
+        if (element.name == dom::Atom::known("html")) {
             assert(open_elements_.empty());
             document_.html().name = std::move(element.name);
             document_.html().attributes = std::move(element.attributes);
-            open_elements_.push_back(&document_.html());
+            push(document_.html());
             return;
         }
 
         dom::Node &node = open_elements_.back()->children.emplace_back(std::move(element));
-        open_elements_.push_back(&std::get<dom::Element>(node));
+        push(std::get<dom::Element>(node));
+    }
+
+    // The stack of element names mirrors the elements so that the parser
+    // states can query it without going through the DOM. The names point into
+    // the elements, so they stay valid for as long as the elements are open.
+    void push(dom::Element &element) {
+        open_elements_.push_back(&element);
+        open_element_stack_.push(element.name);
     }
 
     dom::Document &document_;
-    html2::Tokenizer &tokenizer_;
+    TokenizerT &tokenizer_;
     bool scripting_;
     html2::InsertionMode original_insertion_mode_;
     html2::InsertionMode &current_insertion_mode_;
     std::vector<dom::Element *> &open_elements_;
+    html2::OpenElementStack open_element_stack_;
 };
 
 } // namespace html
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "html/parser.h"
+
+#include "html/corpus_docs_html.h"
+#include "html/corpus_forum_html.h"
+#include "html/corpus_page_html.h"
+
+#include "html2/counting_sink.h"
+#include "html2/tokenizer.h"
+#include "html2/tokenizer_impl.h"
+
+#include "etest/alloc_counter.h"
+#include "etest/etest2.h"
+#include "json/json.h"
+
+#include <nanobench.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+struct Input {
+    std::string name;
+    std::string html;
+};
+
+std::string repeat(std::string_view s, std::size_t times) {
+    std::string out;
+    out.reserve(s.size() * times);
+    for (std::size_t i = 0; i < times; ++i) {
+        out += s;
+    }
+    return out;
+}
+
+// Saved pages, embedded using xxd.
+std::vector<Input> corpus() {
+    auto as_string = [](unsigned char const *data, unsigned size) {
+        return std::string{reinterpret_cast<char const *>(data), size};
+    };
+
+    return {
+            {"article", as_string(archive_corpus_page_html, archive_corpus_page_html_len)},
+            {"forum", as_string(html_corpus_forum_html, html_corpus_forum_html_len)},
+            {"docs", as_string(html_corpus_docs_html, html_corpus_docs_html_len)},
+    };
+}
+
+// Inputs that stress a single part of the parser at a time.
+std::vector<Input> synthetic() {
+    return {
+            {"deep nesting", repeat("<div>", 5'000) + "hello" + repeat("</div>", 5'000)},
+            {"huge attributes", repeat(std::format(R"(<div data-blob="{}"></div>)", std::string(16 * 1024, 'a')), 64)},
+            {"entity-dense text", "<p>" + repeat("&amp;&lt;&gt;&quot;&#169;&#x2014;&nbsp;&hellip; ", 20'000)},
+            {"long comments", repeat("<!--" + repeat("- ab -- cd <!-x- ", 4'000) + "-->", 16)},
+    };
+}
+
+// All inputs from the html5lib tokenizer tests, run as a single document.
+std::optional<Input> html5lib(std::span<char *const> test_files) {
+    if (test_files.empty()) {
+        return std::nullopt;
+    }
+
+    Input input{.name = "html5lib tokenizer tests"};
+    for (char const *path : test_files) {
+        std::ifstream file{path, std::fstream::in | std::fstream::binary};
+        std::string bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        auto json = json::parse(bytes);
+        if (!json) {
+            std::cerr << "Failed to load html5lib test file '" << path << "'\n";
+            std::exit(1);
+        }
+
+        auto const &tests = std::get<json::Array>(std::get<json::Object>(*json).at("tests"));
+        for (auto const &test : tests.values) {
+            auto const &t = std::get<json::Object>(test);
+            if (!t.contains("doubleEscaped")) {
+                input.html += std::get<std::string>(t.at("input"));
+                input.html += '\n';
+            }
+        }
+    }
+
+    return input;
+}
+
+// Runs f, which returns something to check that it did anything, over every
+// input, reporting MB/s and the allocations a single run makes.
+void run_bench(etest::IActions &a,
+        std::string const &title,
+        std::vector<Input> const &inputs,
+        std::function<std::size_t(std::string_view)> const &f) {
+    ankerl::nanobench::Bench bench;
+    bench.title(title).unit("MB");
+
+    for (auto const &input : inputs) {
+        auto const allocations_before = etest::allocation_count();
+        a.expect(f(input.html) > 0, input.name);
+        auto const allocations = etest::allocation_count() - allocations_before;
+
+        auto const name = std::format("{}, {} KiB, {} allocs", input.name, input.html.size() / 1024, allocations);
+        bench.batch(static_cast<double>(input.html.size()) / 1'000'000.).run(name, [&] {
+            ankerl::nanobench::doNotOptimizeAway(f(input.html)); //
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    auto inputs = corpus();
+    for (auto &input : synthetic()) {
+        inputs.push_back(std::move(input));
+    }
+
+    if (auto input = html5lib(std::span{argv, static_cast<std::size_t>(argc)}.subspan(1))) {
+        inputs.push_back(*std::move(input));
+    }
+
+    etest::Suite s;
+
+    s.add_test("tokenize", [&](etest::IActions &a) {
+        run_bench(a, "tokenize", inputs, [](std::string_view html) {
+            html2::BasicTokenizer<html2::CountingSink> tokenizer{html};
+            tokenizer.run();
+            return tokenizer.sink().tokens;
+        });
+    });
+
+    s.add_test("parse", [&](etest::IActions &a) {
+        run_bench(a, "parse", inputs, [](std::string_view html) {
+            auto document = html::parse(html);
+            return document.html().children.size();
+        });
+    });
+
+    return s.run();
+}
@@ -9,6 +9,8 @@
 #include "html2/tokenizer.h"
 
 #include <cstddef>
+#include <format>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -429,5 +431,88 @@ int main() {
         a.expect_eq(errors, std::vector{html2::ParseError::EofInComment});
     });
 
+    s.add_test("fed in chunks", [](etest::IActions &a) {
+        constexpr auto kInput = "<!doctype html><html lang=en><title>T &amp; T</title><p class='a b'>Hello &copy &#x41;"
+                                "<!-- comment --><script>if (a</b) {}</script></p>"sv;
+        auto const expected = html::parse(kInput);
+
+        // Every possible split into two chunks.
+        for (std::size_t i = 0; i <= kInput.size(); ++i) {
+            html::Parser parser;
+            parser.feed(kInput.substr(0, i));
+            parser.feed(kInput.substr(i));
+            a.expect_eq(parser.finish(), expected, std::format("split at {}", i));
+        }
+
+        // And one character at a time.
+        html::Parser parser;
+        for (std::size_t i = 0; i < kInput.size(); ++i) {
+            parser.feed(kInput.substr(i, 1));
+        }
+        a.expect_eq(parser.finish(), expected);
+    });
+
+    s.add_test("partial document", [](etest::IActions &a) {
+        html::Parser parser;
+        parser.feed("<body><p>hello</p><p cla");
+        auto const &partial = body(parser.document());
+        a.expect_eq(partial.children.size(), std::size_t{1});
+        a.expect_eq(partial.children.at(0), dom::Node{dom::Element{"p", {}, {dom::Text{"hello"}}}});
+
+        parser.feed("ss=a>goodbye");
+        a.expect_eq(body(parser.document()).children.size(), std::size_t{2});
+
+        auto document = parser.finish();
+        a.expect_eq(body(document).children.at(1),
+                dom::Node{dom::Element{"p", {{"class", "a"}}, {dom::Text{"goodbye"}}}});
+    });
+
+    s.add_test("text referring to the source", [](etest::IActions &a) {
+        auto source = std::make_shared<std::string const>("<p>hello<b>world</b></p><p>a &amp; b</p><p>x\0y</p>"sv);
+        auto document = html::parse(source);
+        a.expect_eq(document, html::parse(*source));
+        a.expect_eq(document.source(), *source);
+
+        auto const &first = std::get<dom::Element>(body(document).children.at(0));
+        auto const &hello = std::get<dom::Text>(first.children.at(0)).text;
+        a.expect(hello.is_borrowed());
+        a.expect(document.is_source_of(hello));
+        auto const &world = std::get<dom::Text>(std::get<dom::Element>(first.children.at(1)).children.at(0)).text;
+        a.expect(world.is_borrowed());
+
+        // Anything not byte-identical to the source is owned.
+        auto const &second = std::get<dom::Element>(body(document).children.at(1));
+        a.expect_eq(std::get<dom::Text>(second.children.at(0)).text, "a & b");
+        a.expect(!std::get<dom::Text>(second.children.at(0)).text.is_borrowed());
+        auto const &third = std::get<dom::Element>(body(document).children.at(2));
+        a.expect_eq(std::get<dom::Text>(third.children.at(0)).text, "xy");
+        a.expect(!std::get<dom::Text>(third.children.at(0)).text.is_borrowed());
+
+        // Copies share the source.
+        source.reset();
+        auto copy = document;
+        document = dom::Document{};
+        auto const &copied_first = std::get<dom::Element>(body(copy).children.at(0));
+        a.expect_eq(std::get<dom::Text>(copied_first.children.at(0)).text, "hello");
+    });
+
+    s.add_test("parsed documents are indexed", [](etest::IActions &a) {
+        auto document = html::parse(R"(<link rel=stylesheet><p id=a class="x y"><img src=a.png></p><p class=y>)");
+        a.expect(document.has_indexes());
+
+        auto const &p = std::get<dom::Element>(body(document).children.at(0));
+        a.expect_eq(document.element_by_id("a"), &p);
+        a.expect_eq(document.elements_by_tag("link").size(), std::size_t{1});
+        a.expect_eq(document.elements_by_tag("p").size(), std::size_t{2});
+        a.expect_eq(document.elements_by_tag("p")[0], &p);
+        a.expect_eq(document.elements_by_class("y").size(), std::size_t{2});
+        a.expect_eq(document.elements_with_attribute("src")[0], &std::get<dom::Element>(p.children.at(0)));
+
+        html::Parser parser;
+        parser.feed("<p>");
+        a.expect(!parser.document().has_indexes());
+        a.expect(parser.finish().has_indexes());
+    });
+
     return s.run();
 }
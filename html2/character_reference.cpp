@@ -4,7 +4,11 @@
 
 #include "html2/character_reference.h"
 
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string_view>
 
@@ -2262,19 +2266,128 @@ constexpr std::array kReferences = std::to_array<CharacterReference>({{"&AElig"s
         {"&zwj;"sv, 8205},
         {"&zwnj;"sv, 8204}});
 
+constexpr std::size_t kLongestReference = std::ranges::max(kReferences, {}, [](CharacterReference const &r) {
+    return r.name.size();
+}).name.size();
+
+// The references as a trie, with siblings stored in increasing order. The
+// leading '&' shared by all references is the root node.
+struct TrieNode {
+    char c{};
+    std::uint16_t first_child{};
+    std::uint16_t next_sibling{};
+    std::uint16_t reference{kNoReference};
+
+    static constexpr std::uint16_t kNoReference = 0xFFFF;
+};
+
+constexpr std::size_t common_prefix_length(std::string_view a, std::string_view b) {
+    std::size_t i = 0;
+    while (i < a.size() && i < b.size() && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// kReferences is sorted, so each reference adds a node per character after
+// what it has in common with the previous one.
+constexpr std::size_t count_trie_nodes() {
+    std::size_t nodes = 1;
+    std::string_view previous = "&"sv;
+    for (auto const &reference : kReferences) {
+        nodes += reference.name.size() - common_prefix_length(previous, reference.name);
+        previous = reference.name;
+    }
+    return nodes;
+}
+
+constexpr auto kTrie = [] {
+    static_assert(count_trie_nodes() < TrieNode::kNoReference);
+
+    std::array<TrieNode, count_trie_nodes()> trie{};
+    trie[0].c = '&';
+
+    // The nodes for the previous reference's name, indexed by depth.
+    std::array<std::uint16_t, 64> path{};
+    std::string_view previous = "&"sv;
+    std::uint16_t next_node = 1;
+
+    for (std::uint16_t i = 0; i < kReferences.size(); ++i) {
+        auto name = kReferences[i].name;
+        auto const shared = common_prefix_length(previous, name);
+        assert(shared < name.size() && (shared == previous.size() || previous[shared] < name[shared]));
+
+        for (auto depth = shared; depth < name.size(); ++depth) {
+            auto node = next_node++;
+            trie[node].c = name[depth];
+
+            // Being sorted, we either add a sibling after the previous
+            // reference's node where the names diverge, or start a new list
+            // of children.
+            if (depth == shared && depth < previous.size()) {
+                trie[path[depth]].next_sibling = node;
+            } else {
+                trie[path[depth - 1]].first_child = node;
+            }
+
+            path[depth] = node;
+        }
+
+        trie[path[name.size() - 1]].reference = i;
+        previous = name;
+    }
+
+    return trie;
+}();
+
 } // namespace
 
 std::optional<CharacterReference> find_named_character_reference_for(std::string_view buffer) {
+    if (!buffer.starts_with('&')) {
+        return std::nullopt;
+    }
+
     std::optional<CharacterReference> maybe_reference{std::nullopt};
+    std::uint16_t node = 0;
+    for (char c : buffer.substr(1)) {
+        auto child = kTrie[node].first_child;
+        while (child != 0 && kTrie[child].c < c) {
+            child = kTrie[child].next_sibling;
+        }
 
-    for (auto const &reference : kReferences) {
-        if (buffer.starts_with(reference.name)
-                && (!maybe_reference || reference.name.size() > maybe_reference->name.size())) {
-            maybe_reference = reference;
+        if (child == 0 || kTrie[child].c != c) {
+            break;
+        }
+
+        node = child;
+        if (kTrie[node].reference != TrieNode::kNoReference) {
+            maybe_reference = kReferences[kTrie[node].reference];
         }
     }
 
     return maybe_reference;
 }
 
+bool is_named_character_reference_prefix(std::string_view buffer) {
+    if (!buffer.starts_with('&') || buffer.size() >= kLongestReference) {
+        return false;
+    }
+
+    std::uint16_t node = 0;
+    for (char c : buffer.substr(1)) {
+        auto child = kTrie[node].first_child;
+        while (child != 0 && kTrie[child].c < c) {
+            child = kTrie[child].next_sibling;
+        }
+
+        if (child == 0 || kTrie[child].c != c) {
+            return false;
+        }
+
+        node = child;
+    }
+
+    return kTrie[node].first_child != 0;
+}
+
 } // namespace html2
@@ -19,6 +19,10 @@ struct CharacterReference {
 
 std::optional<CharacterReference> find_named_character_reference_for(std::string_view);
 
+// Whether more input could turn the buffer into a longer named reference, i.e.
+// if it's a proper prefix of one.
+bool is_named_character_reference_prefix(std::string_view);
+
 } // namespace html2
 
 #endif
@@ -47,5 +47,31 @@ int main() {
         a.expect(ref->name == "&lt;"sv);
     });
 
+    s.add_test("partial match of a longer reference", [](etest::IActions &a) {
+        auto ref = find_named_character_reference_for("&notit;"sv);
+        a.require(ref.has_value());
+        a.expect(ref->name == "&not"sv); // &notin; shares the first 5 characters.
+
+        a.expect(!find_named_character_reference_for("&am"sv).has_value());
+        a.expect(!find_named_character_reference_for("&"sv).has_value());
+        a.expect(!find_named_character_reference_for("lt;"sv).has_value());
+    });
+
+    s.add_test("first and last references", [](etest::IActions &a) {
+        a.expect(find_named_character_reference_for("&AElig"sv)->name == "&AElig"sv);
+        a.expect(find_named_character_reference_for("&zwnj;"sv)->name == "&zwnj;"sv);
+    });
+
+    s.add_test("prefixes", [](etest::IActions &a) {
+        a.expect(is_named_character_reference_prefix("&"sv));
+        a.expect(is_named_character_reference_prefix("&am"sv));
+        a.expect(is_named_character_reference_prefix("&amp"sv));
+        a.expect(is_named_character_reference_prefix("&CounterClockwiseContourIntegral"sv));
+        a.expect(!is_named_character_reference_prefix("&amp;"sv));
+        a.expect(!is_named_character_reference_prefix("&CounterClockwiseContourIntegral;"sv));
+        a.expect(!is_named_character_reference_prefix("&aaa"sv));
+        a.expect(!is_named_character_reference_prefix("amp"sv));
+    });
+
     return s.run();
 }
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef HTML2_COUNTING_SINK_H_
+#define HTML2_COUNTING_SINK_H_
+
+#include "html2/token.h"
+#include "html2/tokenizer.h"
+
+#include <cstddef>
+
+namespace html2 {
+
+// A token sink that only counts the tokens, for measuring the tokenizer on its
+// own in benchmarks.
+struct CountingSink {
+    std::size_t tokens{};
+    void on_token(BasicTokenizer<CountingSink> &, Token &&) { ++tokens; }
+    void on_error(BasicTokenizer<CountingSink> &, ParseError) {}
+};
+
+} // namespace html2
+
+#endif
@@ -68,6 +68,13 @@ std::pair<std::vector<html2::Token>, std::vector<Error>> tokenize(
                     t.set_state(html2::State::ScriptData);
                 }
 
+                if (auto const *run = std::get_if<html2::CharacterRunToken>(&token)) {
+                    for (char c : run->data) {
+                        tokens.emplace_back(html2::CharacterToken{c});
+                    }
+                    return;
+                }
+
                 tokens.push_back(std::move(token));
             },
             [&](html2::Tokenizer &t, html2::ParseError error) {
@@ -5,6 +5,7 @@
 #ifndef HTML2_IPARSER_ACTIONS_H_
 #define HTML2_IPARSER_ACTIONS_H_
 
+#include "html2/open_elements.h"
 #include "html2/parser_states.h"
 #include "html2/token.h"
 #include "html2/tokenizer.h"
@@ -13,7 +14,6 @@
 #include <span>
 #include <string>
 #include <string_view>
-#include <vector>
 
 namespace html2 {
 
@@ -36,6 +36,7 @@ public:
     virtual std::string_view current_node_name() const = 0;
     virtual void merge_into_html_node(std::span<html2::Attribute const>) = 0;
     virtual void insert_character(html2::CharacterToken const &) = 0;
+    virtual void insert_characters(std::string_view) = 0;
     virtual void set_tokenizer_state(html2::State) = 0;
     virtual void store_original_insertion_mode(InsertionMode) = 0;
     virtual InsertionMode original_insertion_mode() = 0;
@@ -45,8 +46,7 @@ public:
     virtual void reconstruct_active_formatting_elements() = 0;
     virtual void set_foster_parenting(bool) = 0;
 
-    // The most recently opened element is the first element in the list.
-    virtual std::vector<std::string_view> names_of_open_elements() const = 0;
+    virtual OpenElementStack const &open_elements() const = 0;
 
     virtual InsertionMode current_insertion_mode() const = 0;
 };
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "html2/open_elements.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+namespace html2 {
+namespace {
+
+struct ElementFlags {
+    std::string_view name;
+    std::uint8_t flags;
+};
+
+// The elements making up the default scope also bound the button and list
+// item scopes.
+// TODO(robinlinden): Add MathML and SVG elements.
+constexpr std::uint8_t kAnyScopeBoundary =
+        OpenElement::kScopeBoundary | OpenElement::kButtonScopeBoundary | OpenElement::kListItemScopeBoundary;
+
+// Sorted by name.
+constexpr auto kElementFlags = std::to_array<ElementFlags>({
+        {"address", OpenElement::kSpecial},
+        {"applet", OpenElement::kSpecial | kAnyScopeBoundary},
+        {"area", OpenElement::kSpecial},
+        {"article", OpenElement::kSpecial},
+        {"aside", OpenElement::kSpecial},
+        {"base", OpenElement::kSpecial},
+        {"basefont", OpenElement::kSpecial},
+        {"bgsound", OpenElement::kSpecial},
+        {"blockquote", OpenElement::kSpecial},
+        {"body", OpenElement::kSpecial},
+        {"br", OpenElement::kSpecial},
+        {"button", OpenElement::kSpecial | OpenElement::kButtonScopeBoundary},
+        {"caption", OpenElement::kSpecial | kAnyScopeBoundary},
+        {"center", OpenElement::kSpecial},
+        {"col", OpenElement::kSpecial},
+        {"colgroup", OpenElement::kSpecial},
+        {"dd", OpenElement::kSpecial | OpenElement::kImpliedEndTag},
+        {"details", OpenElement::kSpecial},
+        {"dir", OpenElement::kSpecial},
+        {"div", OpenElement::kSpecial},
+        {"dl", OpenElement::kSpecial},
+        {"dt", OpenElement::kSpecial | OpenElement::kImpliedEndTag},
+        {"embed", OpenElement::kSpecial},
+        {"fieldset", OpenElement::kSpecial},
+        {"figcaption", OpenElement::kSpecial},
+        {"figure", OpenElement::kSpecial},
+        {"footer", OpenElement::kSpecial},
+        {"form", OpenElement::kSpecial},
+        {"frame", OpenElement::kSpecial},
+        {"frameset", OpenElement::kSpecial},
+        {"h1", OpenElement::kSpecial},
+        {"h2", OpenElement::kSpecial},
+        {"h3", OpenElement::kSpecial},
+        {"h4", OpenElement::kSpecial},
+        {"h5", OpenElement::kSpecial},
+        {"h6", OpenElement::kSpecial},
+        {"head", OpenElement::kSpecial},
+        {"header", OpenElement::kSpecial},
+        {"hgroup", OpenElement::kSpecial},
+        {"hr", OpenElement::kSpecial},
+        {"html", OpenElement::kSpecial | kAnyScopeBoundary | OpenElement::kTableScopeBoundary},
+        {"iframe", OpenElement::kSpecial},
+        {"img", OpenElement::kSpecial},
+        {"input", OpenElement::kSpecial},
+        {"keygen", OpenElement::kSpecial},
+        {"li", OpenElement::kSpecial | OpenElement::kImpliedEndTag},
+        {"link", OpenElement::kSpecial},
+        {"listing", OpenElement::kSpecial},
+        {"main", OpenElement::kSpecial},
+        {"marquee", OpenElement::kSpecial | kAnyScopeBoundary},
+        {"menu", OpenElement::kSpecial},
+        {"meta", OpenElement::kSpecial},
+        {"nav", OpenElement::kSpecial},
+        {"noembed", OpenElement::kSpecial},
+        {"noframes", OpenElement::kSpecial},
+        {"noscript", OpenElement::kSpecial},
+        {"object", OpenElement::kSpecial | kAnyScopeBoundary},
+        {"ol", OpenElement::kSpecial | OpenElement::kListItemScopeBoundary},
+        {"optgroup", OpenElement::kImpliedEndTag},
+        {"option", OpenElement::kImpliedEndTag},
+        {"p", OpenElement::kSpecial | OpenElement::kImpliedEndTag},
+        {"param", OpenElement::kSpecial},
+        {"plaintext", OpenElement::kSpecial},
+        {"pre", OpenElement::kSpecial},
+        {"rb", OpenElement::kImpliedEndTag},
+        {"rp", OpenElement::kImpliedEndTag},
+        {"rt", OpenElement::kImpliedEndTag},
+        {"rtc", OpenElement::kImpliedEndTag},
+        {"script", OpenElement::kSpecial},
+        {"search", OpenElement::kSpecial},
+        {"section", OpenElement::kSpecial},
+        {"select", OpenElement::kSpecial},
+        {"source", OpenElement::kSpecial},
+        {"style", OpenElement::kSpecial},
+        {"summary", OpenElement::kSpecial},
+        {"table", OpenElement::kSpecial | kAnyScopeBoundary | OpenElement::kTableScopeBoundary},
+        {"tbody", OpenElement::kSpecial},
+        {"td", OpenElement::kSpecial | kAnyScopeBoundary},
+        {"template", OpenElement::kSpecial | kAnyScopeBoundary | OpenElement::kTableScopeBoundary},
+        {"textarea", OpenElement::kSpecial},
+        {"tfoot", OpenElement::kSpecial},
+        {"th", OpenElement::kSpecial | kAnyScopeBoundary},
+        {"thead", OpenElement::kSpecial},
+        {"title", OpenElement::kSpecial},
+        {"tr", OpenElement::kSpecial},
+        {"track", OpenElement::kSpecial},
+        {"ul", OpenElement::kSpecial | OpenElement::kListItemScopeBoundary},
+        {"wbr", OpenElement::kSpecial},
+        {"xmp", OpenElement::kSpecial},
+});
+
+static_assert(std::ranges::is_sorted(kElementFlags, {}, &ElementFlags::name));
+
+} // namespace
+
+std::uint8_t open_element_flags(std::string_view name) {
+    auto it = std::ranges::lower_bound(kElementFlags, name, {}, &ElementFlags::name);
+    if (it == kElementFlags.end() || it->name != name) {
+        return 0;
+    }
+
+    return it->flags;
+}
+
+void OpenElementStack::remove(std::string_view name) {
+    auto it = std::ranges::find(elements_.rbegin(), elements_.rend(), name, &OpenElement::name);
+    if (it != elements_.rend()) {
+        elements_.erase(std::next(it).base());
+    }
+}
+
+bool OpenElementStack::has_element_in_scope(std::string_view name, std::uint8_t scope_boundary) const {
+    for (auto const &element : top_down()) {
+        if (element.name == name) {
+            return true;
+        }
+
+        if (element.is(scope_boundary)) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+} // namespace html2
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef HTML2_OPEN_ELEMENTS_H_
+#define HTML2_OPEN_ELEMENTS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+namespace html2 {
+
+struct OpenElement {
+    // What kind of element this is as far as the tree construction algorithm
+    // cares, looked up once when the element is opened.
+    // https://html.spec.whatwg.org/multipage/parsing.html#special
+    static constexpr std::uint8_t kSpecial = 1U << 0;
+    // https://html.spec.whatwg.org/multipage/parsing.html#generate-implied-end-tags
+    static constexpr std::uint8_t kImpliedEndTag = 1U << 1;
+    // https://html.spec.whatwg.org/multipage/parsing.html#has-an-element-in-the-specific-scope
+    static constexpr std::uint8_t kScopeBoundary = 1U << 2;
+    static constexpr std::uint8_t kButtonScopeBoundary = 1U << 3;
+    static constexpr std::uint8_t kListItemScopeBoundary = 1U << 4;
+    static constexpr std::uint8_t kTableScopeBoundary = 1U << 5;
+
+    std::string_view name{};
+    std::uint8_t flags{};
+
+    [[nodiscard]] constexpr bool is(std::uint8_t flag) const { return (flags & flag) != 0; }
+    [[nodiscard]] bool operator==(OpenElement const &) const = default;
+};
+
+[[nodiscard]] std::uint8_t open_element_flags(std::string_view name);
+
+// https://html.spec.whatwg.org/multipage/parsing.html#stack-of-open-elements
+//
+// Kept by the tree builder so that the parser states can walk it without
+// anything having to be allocated or looked up by name.
+class OpenElementStack {
+public:
+    // The name isn't copied, so it must outlive the element being open, e.g.
+    // by pointing into the element's name.
+    void push(std::string_view name) { elements_.push_back({name, open_element_flags(name)}); }
+    void pop() { elements_.pop_back(); }
+
+    // Removes the most recently opened element with this name, if any.
+    void remove(std::string_view name);
+
+    [[nodiscard]] bool empty() const { return elements_.empty(); }
+    [[nodiscard]] std::size_t size() const { return elements_.size(); }
+    [[nodiscard]] OpenElement const &current() const { return elements_.back(); }
+
+    // The most recently opened element comes first.
+    [[nodiscard]] auto top_down() const { return elements_ | std::views::reverse; }
+
+    // Whether an element with this name is open without any element with the
+    // scope boundary flag between it and the current node.
+    [[nodiscard]] bool has_element_in_scope(std::string_view name, std::uint8_t scope_boundary) const;
+
+private:
+    std::vector<OpenElement> elements_;
+};
+
+} // namespace html2
+
+#endif
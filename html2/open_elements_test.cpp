@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "html2/open_elements.h"
+
+#include "etest/etest2.h"
+
+#include <cstddef>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+using html2::OpenElement;
+using html2::OpenElementStack;
+
+namespace {
+std::vector<std::string_view> names(OpenElementStack const &stack) {
+    auto names = stack.top_down() | std::views::transform(&OpenElement::name);
+    return {names.begin(), names.end()};
+}
+} // namespace
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("flags", [](etest::IActions &a) {
+        a.expect_eq(html2::open_element_flags("div"), OpenElement::kSpecial);
+        a.expect_eq(html2::open_element_flags("option"), OpenElement::kImpliedEndTag);
+        a.expect_eq(html2::open_element_flags("span"), 0);
+        a.expect_eq(html2::open_element_flags(""), 0);
+        a.expect_eq(html2::open_element_flags("zzz"), 0);
+
+        auto p = html2::open_element_flags("p");
+        a.expect((p & OpenElement::kSpecial) != 0);
+        a.expect((p & OpenElement::kImpliedEndTag) != 0);
+
+        auto td = html2::open_element_flags("td");
+        a.expect((td & OpenElement::kScopeBoundary) != 0);
+        a.expect((td & OpenElement::kButtonScopeBoundary) != 0);
+        a.expect((td & OpenElement::kListItemScopeBoundary) != 0);
+        a.expect((td & OpenElement::kTableScopeBoundary) == 0);
+
+        auto button = html2::open_element_flags("button");
+        a.expect((button & OpenElement::kScopeBoundary) == 0);
+        a.expect((button & OpenElement::kButtonScopeBoundary) != 0);
+
+        auto ul = html2::open_element_flags("ul");
+        a.expect((ul & OpenElement::kScopeBoundary) == 0);
+        a.expect((ul & OpenElement::kListItemScopeBoundary) != 0);
+    });
+
+    s.add_test("push, pop, and current", [](etest::IActions &a) {
+        OpenElementStack stack;
+        a.expect(stack.empty());
+
+        stack.push("html");
+        stack.push("body");
+        stack.push("p");
+        a.expect_eq(stack.size(), std::size_t{3});
+        a.expect_eq(stack.current(), OpenElement{"p", html2::open_element_flags("p")});
+        a.expect_eq(names(stack), std::vector<std::string_view>{"p", "body", "html"});
+
+        stack.pop();
+        a.expect_eq(stack.current().name, "body");
+        a.expect_eq(names(stack), std::vector<std::string_view>{"body", "html"});
+    });
+
+    s.add_test("remove", [](etest::IActions &a) {
+        OpenElementStack stack;
+        stack.push("html");
+        stack.push("div");
+        stack.push("head");
+        stack.push("div");
+
+        stack.remove("head");
+        a.expect_eq(names(stack), std::vector<std::string_view>{"div", "div", "html"});
+
+        // Only the most recently opened one is removed.
+        stack.remove("div");
+        a.expect_eq(names(stack), std::vector<std::string_view>{"div", "html"});
+
+        stack.remove("span");
+        a.expect_eq(names(stack), std::vector<std::string_view>{"div", "html"});
+    });
+
+    s.add_test("has element in scope", [](etest::IActions &a) {
+        OpenElementStack stack;
+        stack.push("html");
+        stack.push("body");
+        stack.push("p");
+        stack.push("ul");
+        stack.push("button");
+        stack.push("span");
+
+        a.expect(stack.has_element_in_scope("p", OpenElement::kScopeBoundary));
+        a.expect(!stack.has_element_in_scope("p", OpenElement::kButtonScopeBoundary));
+        a.expect(!stack.has_element_in_scope("p", OpenElement::kListItemScopeBoundary));
+        a.expect(stack.has_element_in_scope("p", OpenElement::kTableScopeBoundary));
+        a.expect(stack.has_element_in_scope("button", OpenElement::kButtonScopeBoundary));
+        a.expect(!stack.has_element_in_scope("div", OpenElement::kScopeBoundary));
+
+        stack.push("table");
+        a.expect(!stack.has_element_in_scope("p", OpenElement::kScopeBoundary));
+        a.expect(!stack.has_element_in_scope("p", OpenElement::kTableScopeBoundary));
+        a.expect(stack.has_element_in_scope("table", OpenElement::kTableScopeBoundary));
+    });
+
+    return s.run();
+}
@@ -5,6 +5,7 @@
 #include "html2/parser_states.h"
 
 #include "html2/iparser_actions.h"
+#include "html2/open_elements.h"
 #include "html2/token.h"
 #include "html2/tokenizer.h"
 
@@ -13,6 +14,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <optional>
 #include <ranges>
 #include <span>
@@ -43,6 +45,7 @@ public:
         wrapped_.merge_into_html_node(attributes);
     }
     void insert_character(html2::CharacterToken const &token) override { wrapped_.insert_character(token); }
+    void insert_characters(std::string_view characters) override { wrapped_.insert_characters(characters); }
     void set_tokenizer_state(html2::State state) override { wrapped_.set_tokenizer_state(state); }
     void store_original_insertion_mode(InsertionMode mode) override { wrapped_.store_original_insertion_mode(mode); }
     InsertionMode original_insertion_mode() override { return wrapped_.original_insertion_mode(); }
@@ -53,7 +56,7 @@ public:
         wrapped_.remove_from_open_elements(element_name);
     }
     void reconstruct_active_formatting_elements() override { wrapped_.reconstruct_active_formatting_elements(); }
-    std::vector<std::string_view> names_of_open_elements() const override { return wrapped_.names_of_open_elements(); }
+    OpenElementStack const &open_elements() const override { return wrapped_.open_elements(); }
     void set_foster_parenting(bool foster) override { wrapped_.set_foster_parenting(foster); }
 
 private:
@@ -183,125 +186,15 @@ constexpr bool is_quirky_when_system_identifier_is_empty(std::string_view public
     return Text{};
 }
 
-// https://html.spec.whatwg.org/multipage/parsing.html#special
-bool is_special(std::string_view node_name) {
-    static constexpr auto kSpecial = std::to_array<std::string_view>({
-            "address",
-            "applet",
-            "area",
-            "article",
-            "aside",
-            "base",
-            "basefont",
-            "bgsound",
-            "blockquote",
-            "body",
-            "br",
-            "button",
-            "caption",
-            "center",
-            "col",
-            "colgroup",
-            "dd",
-            "details",
-            "dir",
-            "div",
-            "dl",
-            "dt",
-            "embed",
-            "fieldset",
-            "figcaption",
-            "figure",
-            "footer",
-            "form",
-            "frame",
-            "frameset",
-            "h1",
-            "h2",
-            "h3",
-            "h4",
-            "h5",
-            "h6",
-            "head",
-            "header",
-            "hgroup",
-            "hr",
-            "html",
-            "iframe",
-            "img",
-            "input",
-            "keygen",
-            "li",
-            "link",
-            "listing",
-            "main",
-            "marquee",
-            "menu",
-            "meta",
-            "nav",
-            "noembed",
-            "noframes",
-            "noscript",
-            "object",
-            "ol",
-            "p",
-            "param",
-            "plaintext",
-            "pre",
-            "script",
-            "search",
-            "section",
-            "select",
-            "source",
-            "style",
-            "summary",
-            "table",
-            "tbody",
-            "td",
-            "template",
-            "textarea",
-            "tfoot",
-            "th",
-            "thead",
-            "title",
-            "tr",
-            "track",
-            "ul",
-            "wbr",
-            "xmp",
-    });
-
-    return is_in_array<kSpecial>(node_name);
-}
-
-// https://html.spec.whatwg.org/multipage/parsing.html#closing-elements-that-have-implied-end-tags
-bool is_implicity_closed(std::string_view node_name) {
-    static constexpr auto kImplicityClosed = std::to_array<std::string_view>({
-            "dd",
-            "dt",
-            "li",
-            "optgroup",
-            "option",
-            "p",
-            "rb",
-            "rp",
-            "rt",
-            "rtc",
-    });
-
-    return is_in_array<kImplicityClosed>(node_name);
-}
-
 void generate_implied_end_tags(IActions &a, std::optional<std::string_view> exception) {
-    while (is_implicity_closed(a.current_node_name()) && a.current_node_name() != exception) {
+    while (a.open_elements().current().is(OpenElement::kImpliedEndTag) && a.current_node_name() != exception) {
         a.pop_current_node();
     }
 }
 
 // https://html.spec.whatwg.org/multipage/parsing.html#reset-the-insertion-mode-appropriately
 InsertionMode appropriate_insertion_mode(IActions &a) {
-    auto open_elements = a.names_of_open_elements();
-    for (auto node : open_elements) {
+    for (auto node : a.open_elements().top_down() | std::views::transform(&OpenElement::name)) {
         // TODO(robinlinden): Lots of table nonsense.
         if (node == "table") {
             return InTable{};
@@ -330,63 +223,49 @@ InsertionMode appropriate_insertion_mode(IActions &a) {
     return InBody{};
 }
 
-template<auto const &scope_elements>
-bool has_element_in_scope_impl(IActions const &a, std::string_view element_name) {
-    for (auto const element : a.names_of_open_elements()) {
-        if (element == element_name) {
-            return true;
-        }
-
-        if (is_in_array<scope_elements>(element)) {
-            return false;
-        }
-    }
-
-    return false;
-}
-
 // https://html.spec.whatwg.org/multipage/parsing.html#has-an-element-in-scope
 bool has_element_in_scope(IActions const &a, std::string_view element_name) {
-    static constexpr auto kScopeElements = std::to_array<std::string_view>({
-            "applet", "caption", "html", "table", "td", "th", "marquee", "object", "template",
-            // TODO(robinlinden): Add MathML and SVG elements.
-            // MathML mi, MathML mo, MathML mn, MathML ms, MathML mtext,
-            // MathML annotation-xml, SVG foreignObject, SVG desc, SVG
-            // title,
-    });
-
-    return has_element_in_scope_impl<kScopeElements>(a, element_name);
+    return a.open_elements().has_element_in_scope(element_name, OpenElement::kScopeBoundary);
 }
 
 // https://html.spec.whatwg.org/multipage/parsing.html#has-an-element-in-button-scope
 bool has_element_in_button_scope(IActions const &a, std::string_view element_name) {
-    static constexpr auto kScopeElements = std::to_array<std::string_view>({
-            "button", "applet", "caption", "html", "table", "td", "th", "marquee", "object", "template",
-            // TODO(robinlinden): Add MathML and SVG elements.
-            // MathML mi, MathML mo, MathML mn, MathML ms, MathML mtext,
-            // MathML annotation-xml, SVG foreignObject, SVG desc, SVG
-            // title,
-    });
-
-    return has_element_in_scope_impl<kScopeElements>(a, element_name);
+    return a.open_elements().has_element_in_scope(element_name, OpenElement::kButtonScopeBoundary);
 }
 
 // https://html.spec.whatwg.org/multipage/parsing.html#has-an-element-in-list-item-scope
 bool has_element_in_list_item_scope(IActions const &a, std::string_view element_name) {
-    static constexpr auto kScopeElements = std::to_array<std::string_view>({
-            "ol", "ul", "applet", "caption", "html", "table", "td", "th", "marquee", "object", "template",
-            // TODO(robinlinden): Add MathML and SVG elements.
-    });
-
-    return has_element_in_scope_impl<kScopeElements>(a, element_name);
+    return a.open_elements().has_element_in_scope(element_name, OpenElement::kListItemScopeBoundary);
 }
 
 bool has_element_in_table_scope(IActions const &a, std::string_view element_name) {
-    static constexpr auto kScopeElements = std::to_array<std::string_view>({"html", "table", "template"});
-    return has_element_in_scope_impl<kScopeElements>(a, element_name);
+    return a.open_elements().has_element_in_scope(element_name, OpenElement::kTableScopeBoundary);
 }
 } // namespace
 
+void process_token(InsertionMode &mode, IActions &a, html2::Token const &token) {
+    auto process = [&](html2::Token const &t) {
+        mode = std::visit([&](auto &m) { return m.process(a, t); }, mode).value_or(mode);
+    };
+
+    auto const *run = std::get_if<html2::CharacterRunToken>(&token);
+    if (run == nullptr) {
+        process(token);
+        return;
+    }
+
+    // The other insertion modes treat (some) characters differently from each
+    // other, and may switch insertion mode halfway through the run.
+    for (std::size_t i = 0; i < run->data.size(); ++i) {
+        if (std::holds_alternative<InBody>(mode) || std::holds_alternative<Text>(mode)) {
+            process(html2::CharacterRunToken{run->data.substr(i)});
+            return;
+        }
+
+        process(html2::CharacterToken{run->data[i]});
+    }
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#the-initial-insertion-mode
 // Incomplete.
 std::optional<InsertionMode> Initial::process(IActions &a, html2::Token const &token) {
@@ -743,6 +622,16 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
         return {};
     }
 
+    // Runs never contain U+0000, so they can be inserted as-is.
+    if (auto const *run = std::get_if<html2::CharacterRunToken>(&token)) {
+        a.reconstruct_active_formatting_elements();
+        a.insert_characters(run->data);
+        if (run->data.find_first_not_of("\t\n\f\r "sv) != std::string_view::npos) {
+            a.set_frameset_ok(false);
+        }
+        return {};
+    }
+
     if (is_boring_whitespace(token)) {
         a.reconstruct_active_formatting_elements();
         a.insert_character(std::get<html2::CharacterToken>(token));
@@ -807,7 +696,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
             return {};
         }
 
-        auto open_elements = a.names_of_open_elements();
+        auto open_elements = a.open_elements().top_down() | std::views::transform(&OpenElement::name);
         if (std::ranges::find_if_not(open_elements, [](auto const &name) {
                 static constexpr auto kAllowedElements = std::to_array<std::string_view>({
                         "dd",
@@ -830,7 +719,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
                         "html",
                 });
                 return is_in_array<kAllowedElements>(name);
-            }) != std::cend(open_elements)) {
+            }) != std::ranges::end(open_elements)) {
             // Parse error.
         }
 
@@ -843,7 +732,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
             return {};
         }
 
-        auto open_elements = a.names_of_open_elements();
+        auto open_elements = a.open_elements().top_down() | std::views::transform(&OpenElement::name);
         if (std::ranges::find_if_not(open_elements, [](auto const &name) {
                 static constexpr auto kAllowedElements = std::to_array<std::string_view>({
                         "dd",
@@ -866,7 +755,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
                         "html",
                 });
                 return is_in_array<kAllowedElements>(name);
-            }) != std::cend(open_elements)) {
+            }) != std::ranges::end(open_elements)) {
             // Parse error.
         }
 
@@ -917,10 +806,9 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
     if (start != nullptr && start->tag_name == "li") {
         a.set_frameset_ok(false);
 
-        auto open_elements = a.names_of_open_elements();
-        assert(!open_elements.empty());
-        for (auto node : open_elements) {
-            if (node == "li") {
+        assert(!a.open_elements().empty());
+        for (auto node : a.open_elements().top_down()) {
+            if (node.name == "li") {
                 generate_implied_end_tags(a, "li");
                 if (a.current_node_name() != "li") {
                     // Parse error.
@@ -934,7 +822,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
                 break;
             }
 
-            if (is_special(node) && node != "address" && node != "div" && node != "p") {
+            if (node.is(OpenElement::kSpecial) && node.name != "address" && node.name != "div" && node.name != "p") {
                 break;
             }
         }
@@ -950,16 +838,15 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
     if (start != nullptr && (start->tag_name == "dd" || start->tag_name == "dt")) {
         a.set_frameset_ok(false);
 
-        auto open_elements = a.names_of_open_elements();
-        assert(!open_elements.empty());
-        for (auto node : open_elements) {
-            if (node == "dd" || node == "dt") {
-                generate_implied_end_tags(a, node);
-                if (a.current_node_name() != node) {
+        assert(!a.open_elements().empty());
+        for (auto node : a.open_elements().top_down()) {
+            if (node.name == "dd" || node.name == "dt") {
+                generate_implied_end_tags(a, node.name);
+                if (a.current_node_name() != node.name) {
                     // Parse error.
                 }
 
-                while (a.current_node_name() != node) {
+                while (a.current_node_name() != node.name) {
                     a.pop_current_node();
                 }
 
@@ -967,7 +854,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
                 break;
             }
 
-            if (is_special(node) && node != "address" && node != "div" && node != "p") {
+            if (node.is(OpenElement::kSpecial) && node.name != "address" && node.name != "div" && node.name != "p") {
                 break;
             }
         }
@@ -1116,8 +1003,8 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
     }
 
     if (end != nullptr) {
-        for (auto const name : a.names_of_open_elements()) {
-            if (name == end->tag_name) {
+        for (auto const &node : a.open_elements().top_down()) {
+            if (node.name == end->tag_name) {
                 generate_implied_end_tags(a, end->tag_name);
                 if (a.current_node_name() != end->tag_name) {
                     // Parse error.
@@ -1131,7 +1018,7 @@ std::optional<InsertionMode> InBody::process(IActions &a, html2::Token const &to
                 break;
             }
 
-            if (is_special(name)) {
+            if (node.is(OpenElement::kSpecial)) {
                 // Parse error.
                 return {};
             }
@@ -1152,6 +1039,11 @@ std::optional<InsertionMode> Text::process(IActions &a, html2::Token const &toke
         return {};
     }
 
+    if (auto const *run = std::get_if<html2::CharacterRunToken>(&token)) {
+        a.insert_characters(run->data);
+        return {};
+    }
+
     if (std::holds_alternative<html2::EndOfFileToken>(token)) {
         // Parse error.
         // TODO(robinlinden): If current node is a script, set its already-started to true.
@@ -131,6 +131,11 @@ struct AfterAfterBody {
     std::optional<InsertionMode> process(IActions &, html2::Token const &);
 };
 
+// Processes the token in the current insertion mode, switching to the next
+// insertion mode if needed. Character runs are handed to the insertion modes
+// that can insert them in bulk, and split into single characters otherwise.
+void process_token(InsertionMode &, IActions &, html2::Token const &);
+
 } // namespace html2
 
 #endif
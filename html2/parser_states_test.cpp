@@ -23,7 +23,7 @@
 
 using namespace std::literals;
 
-using NodeVec = std::vector<dom::Node>;
+using NodeVec = std::pmr::vector<dom::Node>;
 
 namespace {
 struct ParseResult {
@@ -46,7 +46,7 @@ ParseResult parse(std::string_view html, ParseOptions const &opts) {
     html::Actions actions{res.document, tokenizer, opts.scripting, mode, open_elements};
 
     auto on_token = [&](html2::Tokenizer &, html2::Token const &token) {
-        mode = std::visit([&](auto &v) { return v.process(actions, token); }, mode).value_or(mode);
+        html2::process_token(mode, actions, token);
     };
 
     tokenizer = html2::Tokenizer{html, std::move(on_token)};
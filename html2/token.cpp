@@ -25,6 +25,7 @@ public:
     std::string operator()(EndTagToken const &t) { return std::format("EndTag {}", t.tag_name); }
     std::string operator()(CommentToken const &t) { return std::format("Comment {}", t.data); }
     std::string operator()(CharacterToken const &t) { return std::format("Character {}", t.data); }
+    std::string operator()(CharacterRunToken const &t) { return std::format("Characters {}", t.data); }
     std::string operator()(EndOfFileToken const &) { return "EndOfFile"; }
 };
 
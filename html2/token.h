@@ -7,6 +7,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -48,11 +49,25 @@ struct CharacterToken {
     [[nodiscard]] bool operator==(CharacterToken const &) const = default;
 };
 
+// A run of characters emitted in one go instead of one CharacterToken per
+// character. The data points into the tokenizer input, or into static storage
+// for things like replacement characters, and never contains U+0000.
+struct CharacterRunToken {
+    std::string_view data{};
+    [[nodiscard]] bool operator==(CharacterRunToken const &) const = default;
+};
+
 struct EndOfFileToken {
     [[nodiscard]] bool operator==(EndOfFileToken const &) const = default;
 };
 
-using Token = std::variant<DoctypeToken, StartTagToken, EndTagToken, CommentToken, CharacterToken, EndOfFileToken>;
+using Token = std::variant<DoctypeToken,
+        StartTagToken,
+        EndTagToken,
+        CommentToken,
+        CharacterToken,
+        CharacterRunToken,
+        EndOfFileToken>;
 
 std::string to_string(Token const &);
 
@@ -41,6 +41,10 @@ int main() {
         a.expect_eq(to_string(CharacterToken{'?'}), "Character ?");
     });
 
+    s.add_test("to_string(CharacterRun)", [](etest::IActions &a) {
+        a.expect_eq(to_string(CharacterRunToken{"hello"}), "Characters hello"); //
+    });
+
     s.add_test("to_string(EndOfFile)", [](etest::IActions &a) {
         a.expect_eq(to_string(EndOfFileToken{}), "EndOfFile"); //
     });
@@ -253,19 +253,52 @@ struct SourceLocation {
     [[nodiscard]] bool operator==(SourceLocation const &) const = default;
 };
 
-class Tokenizer {
+template<typename Sink>
+class BasicTokenizer;
+
+// Delivers tokens and parse errors using std::function, for when being able to
+// pass in any callable is worth more than having the token handling inlined.
+class FunctionSink {
 public:
-    Tokenizer(
-            std::string_view input,
-            std::function<void(Tokenizer &, Token &&)> on_emit,
-            std::function<void(Tokenizer &, ParseError)> on_error = [](auto &, auto) {})
-        : input_{input}, on_emit_{std::move(on_emit)}, on_error_{std::move(on_error)} {}
+    FunctionSink(std::function<void(BasicTokenizer<FunctionSink> &, Token &&)> on_emit,
+            std::function<void(BasicTokenizer<FunctionSink> &, ParseError)> on_error = [](auto &, auto) {})
+        : on_emit_{std::move(on_emit)}, on_error_{std::move(on_error)} {}
+
+    void on_token(BasicTokenizer<FunctionSink> &tokenizer, Token &&token) { on_emit_(tokenizer, std::move(token)); }
+    void on_error(BasicTokenizer<FunctionSink> &tokenizer, ParseError error) { on_error_(tokenizer, error); }
+
+private:
+    std::function<void(BasicTokenizer<FunctionSink> &, Token &&)> on_emit_{};
+    std::function<void(BasicTokenizer<FunctionSink> &, ParseError)> on_error_{};
+};
+
+// Tokens and parse errors are delivered to the sink's on_token(BasicTokenizer &, Token &&)
+// and on_error(BasicTokenizer &, ParseError), which are called directly, so
+// they can be inlined. The implementation lives in html2/tokenizer_impl.h.
+template<typename Sink>
+class BasicTokenizer {
+public:
+    template<typename... SinkArgs>
+    BasicTokenizer(std::string_view input, SinkArgs &&...sink_args)
+        : input_{input}, sink_{std::forward<SinkArgs>(sink_args)...} {}
 
     void set_state(State);
+
+    // Tokenizes all of the input, treating its end as the end of the file.
     void run();
 
+    // For input arriving in chunks: feed() tokenizes as much as possible,
+    // holding on to anything that can't be tokenized until more input is
+    // available, e.g. half a tag or character reference. finish() then
+    // tokenizes the rest, treating the end of the input as the end of the file.
+    void feed(std::string_view);
+    void finish();
+
     [[nodiscard]] SourceLocation current_source_location() const;
 
+    Sink &sink() { return sink_; }
+    Sink const &sink() const { return sink_; }
+
     // This will definitely change once we implement the tree construction, but this works for now.
     // https://html.spec.whatwg.org/multipage/parsing.html#markup-declaration-open-state
     void set_adjusted_current_node_in_html_namespace(bool in_html_namespace) {
@@ -275,6 +308,16 @@ public:
 private:
     std::string_view input_;
     std::size_t pos_{0};
+    // When fed input in chunks, input_ points into this, and anything that's
+    // been tokenized is dropped when the next chunk arrives.
+    std::string buffer_{};
+    SourceLocation buffer_start_{.line = 1, .column = 0};
+    // Offsets into input_ of the newlines before newlines_indexed_to_, indexed
+    // lazily as source locations are needed so that finding one doesn't mean
+    // counting the newlines from the start of the input every time.
+    mutable std::vector<std::size_t> newlines_{};
+    mutable std::size_t newlines_indexed_to_{0};
+    bool finished_{false};
     State state_{State::Data};
     State return_state_{};
     Token current_token_{};
@@ -290,12 +333,15 @@ private:
     bool self_closing_end_tag_detected_{false};
     std::vector<Attribute> end_tag_attributes_{};
 
-    std::function<void(Tokenizer &, Token &&)> on_emit_{};
-    std::function<void(Tokenizer &, ParseError)> on_error_{};
+    Sink sink_;
 
+    void tokenize();
+    SourceLocation source_location_at(std::size_t) const;
     void emit(ParseError);
     void emit(Token &&);
     std::optional<char> consume_next_input_character();
+    template<char... StopCharacters>
+    std::string_view consume_characters_until();
     std::optional<char> peek_next_input_character() const;
     bool is_eof() const;
 
@@ -311,6 +357,9 @@ private:
     void emit_replacement_character();
 };
 
+using Tokenizer = BasicTokenizer<FunctionSink>;
+extern template class BasicTokenizer<FunctionSink>;
+
 } // namespace html2
 
 #endif
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "html2/tokenizer.h"
+#include "html2/tokenizer_impl.h"
+
+#include "html2/counting_sink.h"
+#include "html2/token.h"
+
+#include "etest/etest2.h"
+
+#include <nanobench.h>
+
+#include <cstddef>
+#include <format>
+#include <string>
+
+namespace {
+
+// Lots of small tokens, which is where the per-token overhead matters.
+std::string make_document() {
+    std::string html = "<!DOCTYPE html><html><head><title>Items</title></head><body><ul>";
+    for (int i = 0; i < 1000; ++i) {
+        html += std::format(R"(<li class="item" id="item-{}"><a href="/items/{}">Item</a> &amp; <b>{}</b></li>)", i, i, i);
+    }
+    html += "</ul></body></html>";
+    return html;
+}
+
+} // namespace
+
+int main() {
+    etest::Suite s;
+
+    s.add_test("tokenizer: token sinks", [](etest::IActions &a) {
+        auto const html = make_document();
+
+        std::size_t function_tokens{};
+        auto tokenize_with_function = [&] {
+            function_tokens = 0;
+            html2::Tokenizer{html, [&](html2::Tokenizer &, html2::Token &&) { ++function_tokens; }}.run();
+        };
+
+        std::size_t static_tokens{};
+        auto tokenize_with_static_sink = [&] {
+            html2::BasicTokenizer<html2::CountingSink> tokenizer{html};
+            tokenizer.run();
+            static_tokens = tokenizer.sink().tokens;
+        };
+
+        tokenize_with_function();
+        tokenize_with_static_sink();
+        a.expect_eq(function_tokens, static_tokens);
+
+        ankerl::nanobench::Bench bench;
+        bench.title("tokenizer: token sinks").unit("token").batch(static_tokens);
+        bench.run("std::function", tokenize_with_function);
+        bench.run("static sink", tokenize_with_static_sink);
+    });
+
+    return s.run();
+}
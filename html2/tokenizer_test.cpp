@@ -9,6 +9,7 @@
 #include "etest/etest2.h"
 
 #include <array>
+#include <cstddef>
 #include <format>
 #include <iterator>
 #include <optional>
@@ -51,13 +52,14 @@ struct Options {
     std::optional<html2::State> state_override{};
 };
 
-TokenizerOutput run_tokenizer(etest::IActions &a,
-        std::string_view input,
-        Options const &opts = Options{},
-        std::source_location loc = std::source_location::current()) {
+struct Tokenized {
     std::vector<Token> tokens;
     std::vector<ParseErrorWithLocation> errors;
-    Tokenizer tokenizer{input,
+};
+
+Tokenized tokenize(std::string_view input, Options const &opts, bool one_character_at_a_time) {
+    Tokenized out;
+    Tokenizer tokenizer{one_character_at_a_time ? ""sv : input,
             [&](Tokenizer &the, Token &&t) {
                 if (auto const *start_tag = std::get_if<StartTagToken>(&t)) {
                     if (start_tag->tag_name == "script") {
@@ -68,16 +70,47 @@ TokenizerOutput run_tokenizer(etest::IActions &a,
                         the.set_state(State::Rcdata);
                     }
                 }
-                tokens.push_back(std::move(t));
+                // Runs are split up so that tests don't depend on how the
+                // tokenizer batches characters.
+                if (auto const *run = std::get_if<CharacterRunToken>(&t)) {
+                    for (char c : run->data) {
+                        out.tokens.emplace_back(CharacterToken{c});
+                    }
+                    return;
+                }
+
+                out.tokens.push_back(std::move(t));
             },
             [&](Tokenizer &the, ParseError e) {
-                errors.push_back({e, the.current_source_location()});
+                out.errors.push_back({e, the.current_source_location()});
             }};
     if (opts.state_override) {
         tokenizer.set_state(*opts.state_override);
     }
     tokenizer.set_adjusted_current_node_in_html_namespace(opts.in_html_namespace);
-    tokenizer.run();
+
+    if (!one_character_at_a_time) {
+        tokenizer.run();
+        return out;
+    }
+
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        tokenizer.feed(input.substr(i, 1));
+    }
+    tokenizer.finish();
+    return out;
+}
+
+// Every input is also fed to the tokenizer one character at a time to make
+// sure that it can stop and pick up tokenizing anywhere.
+TokenizerOutput run_tokenizer(etest::IActions &a,
+        std::string_view input,
+        Options const &opts = Options{},
+        std::source_location loc = std::source_location::current()) {
+    auto [tokens, errors] = tokenize(input, opts, false);
+    auto chunked = tokenize(input, opts, true);
+    a.expect(chunked.tokens == tokens, "Different tokens when fed one character at a time", loc);
+    a.expect(chunked.errors == errors, "Different errors when fed one character at a time", loc);
 
     return {a, std::move(tokens), std::move(errors), std::move(loc)};
 }
@@ -123,6 +156,24 @@ void data_tests(etest::Suite &s) {
         expect_error(tokens, ParseError::UnexpectedNullCharacter);
         expect_token(tokens, EndOfFileToken{});
     });
+
+    s.add_test("data, character runs", [](etest::IActions &a) {
+        std::vector<Token> tokens;
+        Tokenizer{"hello <p>world&amp;\0!"sv, [&](Tokenizer &, Token &&t) {
+                      tokens.push_back(std::move(t));
+                  }}.run();
+
+        a.expect_eq(tokens,
+                std::vector<Token>{
+                        CharacterRunToken{"hello "},
+                        StartTagToken{.tag_name = "p"},
+                        CharacterRunToken{"world"},
+                        CharacterToken{'&'},
+                        CharacterToken{'\0'},
+                        CharacterRunToken{"!"},
+                        EndOfFileToken{},
+                });
+    });
 }
 
 void cdata_tests(etest::Suite &s) {
@@ -411,6 +462,15 @@ void source_location_tests(etest::Suite &s) {
         expect_error(tokens, {ParseError::EofInCdata, {2, 1}});
         expect_token(tokens, EndOfFileToken{});
     });
+
+    s.add_test("src loc: error right before a newline", [](etest::IActions &a) {
+        auto tokens = run_tokenizer(a, "\n<#\n<#");
+        expect_error(tokens, {ParseError::InvalidFirstCharacterOfTagName, {2, 2}});
+        expect_text(tokens, "\n<#\n");
+        expect_error(tokens, {ParseError::InvalidFirstCharacterOfTagName, {3, 2}});
+        expect_text(tokens, "<#");
+        expect_token(tokens, EndOfFileToken{});
+    });
 }
 
 void tag_open_tests(etest::Suite &s) {
@@ -575,6 +635,18 @@ void attribute_value_double_quoted_tests(etest::Suite &s) {
         expect_error(tokens, ParseError::EofInTag);
         expect_token(tokens, EndOfFileToken{});
     });
+
+    s.add_test("attribute value double quoted: long value", [](etest::IActions &a) {
+        auto tokens = run_tokenizer(a, "<p a=\"the quick brown fox &amp; the lazy dog\0 jumped over 'it'\">"sv);
+        expect_error(tokens, ParseError::UnexpectedNullCharacter);
+        expect_token(tokens,
+                StartTagToken{
+                        .tag_name = "p",
+                        .attributes = {{"a", std::format("the quick brown fox & the lazy dog{} jumped over 'it'",
+                                                     kReplacementCharacter)}},
+                });
+        expect_token(tokens, EndOfFileToken{});
+    });
 }
 
 void attribute_value_single_quoted_tests(etest::Suite &s) {
@@ -1144,6 +1216,17 @@ int main() {
         expect_token(tokens, EndOfFileToken{});
     });
 
+    s.add_test("character entity reference, long alphanumeric run fed in chunks", [](etest::IActions &a) {
+        auto input = "&"s + std::string(100'000, 'a');
+        auto [tokens, errors] = tokenize(input, {}, true);
+        a.expect(errors.empty());
+        a.require_eq(tokens.size(), input.size() + 1);
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            a.expect_eq(tokens[i], Token{CharacterToken{input[i]}});
+        }
+        a.expect_eq(tokens.back(), Token{EndOfFileToken{}});
+    });
+
     s.add_test("ambiguous ampersand", [](etest::IActions &a) {
         auto tokens = run_tokenizer(a, "&blah;");
         expect_text(tokens, "&blah;");
@@ -89,10 +89,10 @@ std::optional<LayoutBox> create_tree(
         return std::nullopt;
     }
 
-    if (auto const &element = std::get<dom::Element>(node.node); element.name == "img"sv) {
-        auto src = element.attributes.find("src"sv);
+    if (auto const &element = std::get<dom::Element>(node.node); element.name == dom::Atom::known("img")) {
+        auto src = element.attributes.find(dom::Atom::known("src"));
         if (src == element.attributes.end() || !resource_exists(src->second)) {
-            if (auto alt = element.attributes.find("alt"sv); alt != element.attributes.end()) {
+            if (auto alt = element.attributes.find(dom::Atom::known("alt")); alt != element.attributes.end()) {
                 return LayoutBox{.node = &node, .layout_text = std::string_view{alt->second}};
             }
         }
@@ -315,11 +315,11 @@ type::Weight to_type(std::optional<style::FontWeight> const &weight) {
 std::string_view try_get_src(LayoutBox const &box) {
     assert(!box.is_anonymous_block());
     auto const *img = std::get_if<dom::Element>(&box.node->node);
-    if (img == nullptr || img->name != "img"sv) {
+    if (img == nullptr || img->name != dom::Atom::known("img")) {
         return {};
     }
 
-    auto src = img->attributes.find("src"sv);
+    auto src = img->attributes.find(dom::Atom::known("src"));
     if (src == img->attributes.end()) {
         return {};
     }
@@ -416,7 +416,8 @@ void Layouter::layout_anonymous_block(LayoutBox &box, geom::Rect const &bounds,
         // TODO(robinlinden): This needs to get along better with whitespace
         // collapsing. A <br> followed by a whitespace will be lead to a leading
         // space on the new line.
-        if (auto const *ele = std::get_if<dom::Element>(&child->node->node); ele != nullptr && ele->name == "br"sv) {
+        if (auto const *ele = std::get_if<dom::Element>(&child->node->node);
+                ele != nullptr && ele->name == dom::Atom::known("br")) {
             current_line += 1;
             last_child_end = 0;
             continue;
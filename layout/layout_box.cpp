@@ -11,15 +11,18 @@
 #include "style/styled_node.h"
 
 #include <cassert>
-#include <cstdint>
+#include <cstddef>
 #include <format>
+#include <iterator>
 #include <optional>
 #include <ostream>
+#include <ranges>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <variant>
+#include <vector>
 
 using namespace std::literals;
 
@@ -41,39 +44,18 @@ std::string_view layout_type(LayoutBox const &box) {
     return "block";
 }
 
-std::string to_str(geom::Rect const &rect) {
-    return std::format("{{{},{},{},{}}}", rect.x, rect.y, rect.width, rect.height);
-}
-
-std::string to_str(geom::EdgeSize const &edge) {
-    return std::format("{{{},{},{},{}}}", edge.top, edge.right, edge.bottom, edge.left);
-}
-
-// NOLINTNEXTLINE(misc-no-recursion)
-void print_box(LayoutBox const &box, std::ostream &os, std::uint8_t depth = 0) {
-    for (std::uint8_t i = 0; i < depth; ++i) {
+void print_indent(std::ostream &os, std::size_t depth) {
+    for (std::size_t i = 0; i < depth; ++i) {
         os << "  ";
     }
+}
 
-    if (box.node != nullptr) {
-        if (auto const *element = std::get_if<dom::Element>(&box.node->node)) {
-            os << element->name << '\n';
-        } else {
-            auto text = box.text();
-            assert(text.has_value());
-            os << text.value() << '\n';
-        }
-
-        for (std::uint8_t i = 0; i < depth; ++i) {
-            os << "  ";
-        }
-    }
+void print_rect(std::ostream &os, geom::Rect const &rect) {
+    std::format_to(std::ostreambuf_iterator{os}, "{{{},{},{},{}}}", rect.x, rect.y, rect.width, rect.height);
+}
 
-    auto const &d = box.dimensions;
-    os << layout_type(box) << " " << to_str(d.content) << " " << to_str(d.padding) << " " << to_str(d.margin) << '\n';
-    for (auto const &child : box.children) {
-        print_box(child, os, depth + 1);
-    }
+void print_edges(std::ostream &os, geom::EdgeSize const &edge) {
+    std::format_to(std::ostreambuf_iterator{os}, "{{{},{},{},{}}}", edge.top, edge.right, edge.bottom, edge.left);
 }
 
 } // namespace
@@ -106,9 +88,42 @@ LayoutBox const *box_at_position(LayoutBox const &box, geom::Position p) {
     return &box;
 }
 
+void print(LayoutBox const &root, std::ostream &os) {
+    std::vector<std::pair<LayoutBox const *, std::size_t>> to_print{{&root, 0}};
+    while (!to_print.empty()) {
+        auto [box, depth] = to_print.back();
+        to_print.pop_back();
+
+        if (box->node != nullptr) {
+            print_indent(os, depth);
+            if (auto const *element = std::get_if<dom::Element>(&box->node->node)) {
+                os << element->name.str() << '\n';
+            } else {
+                auto text = box->text();
+                assert(text.has_value());
+                os << text.value() << '\n';
+            }
+        }
+
+        auto const &d = box->dimensions;
+        print_indent(os, depth);
+        os << layout_type(*box) << ' ';
+        print_rect(os, d.content);
+        os << ' ';
+        print_edges(os, d.padding);
+        os << ' ';
+        print_edges(os, d.margin);
+        os << '\n';
+
+        for (auto const &child : box->children | std::views::reverse) {
+            to_print.emplace_back(&child, depth + 1);
+        }
+    }
+}
+
 std::string to_string(LayoutBox const &box) {
     std::stringstream ss;
-    print_box(box, ss);
+    print(box, ss);
     return std::move(ss).str();
 }
 
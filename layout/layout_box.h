@@ -13,7 +13,10 @@
 #include "style/styled_node.h"
 
 #include <cassert>
+#include <iosfwd>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -55,6 +58,7 @@ struct LayoutBox {
 
 LayoutBox const *box_at_position(LayoutBox const &, geom::Position);
 
+void print(LayoutBox const &, std::ostream &);
 std::string to_string(LayoutBox const &box);
 
 inline std::string_view dom_name(LayoutBox const &node) {
@@ -62,30 +66,21 @@ inline std::string_view dom_name(LayoutBox const &node) {
     return std::get<dom::Element>(node.node->node).name;
 }
 
-inline std::vector<LayoutBox const *> dom_children(LayoutBox const &node) {
+// The element children of the box, with anonymous blocks replaced by their
+// children. This is a view into the layout tree, so nothing is allocated.
+inline auto dom_children(LayoutBox const &node) {
     assert(node.node);
-    std::vector<LayoutBox const *> children{};
-    for (auto const &child : node.children) {
-        if (child.is_anonymous_block()) {
-            for (auto const &inline_child : child.children) {
-                assert(inline_child.node);
-                if (!std::holds_alternative<dom::Element>(inline_child.node->node)) {
-                    continue;
-                }
-
-                children.push_back(&inline_child);
-            }
-            continue;
-        }
-
+    // Anonymous blocks never contain other anonymous blocks.
+    auto flatten_anonymous = [](LayoutBox const &child) {
+        return child.is_anonymous_block() ? std::span{child.children} : std::span{&child, 1};
+    };
+    auto is_element = [](LayoutBox const &child) {
         assert(child.node);
-        if (!std::holds_alternative<dom::Element>(child.node->node)) {
-            continue;
-        }
-
-        children.push_back(&child);
-    }
-    return children;
+        return std::holds_alternative<dom::Element>(child.node->node);
+    };
+    auto to_pointer = [](LayoutBox const &child) { return &child; };
+    return node.children | std::views::transform(flatten_anonymous) | std::views::join
+            | std::views::filter(is_element) | std::views::transform(to_pointer);
 }
 
 } // namespace layout
@@ -15,6 +15,7 @@
 #include "style/unresolved_value.h"
 
 #include <cstddef>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -187,7 +188,24 @@ int main() {
                 "        inline {0,0,35,10} {0,0,0,0} {0,0,0,0}\n"
                 "    p\n"
                 "    block {0,30,35,0} {5,15,0,0} {0,0,0,0}\n";
-        a.expect_eq(to_string(layout::create_layout(style_root, 0).value()), expected);
+        auto const layout = layout::create_layout(style_root, 0).value();
+        a.expect_eq(to_string(layout), expected);
+
+        std::stringstream ss;
+        layout::print(layout, ss);
+        a.expect_eq(ss.str(), expected);
+    });
+
+    s.add_test("to_string, deep tree", [](etest::IActions &a) {
+        layout::LayoutBox root{};
+        auto *current = &root;
+        for (int i = 0; i < 300; ++i) {
+            current = &current->children.emplace_back();
+        }
+
+        auto printed = to_string(root);
+        a.expect(printed.starts_with("ablock {0,0,0,0} {0,0,0,0} {0,0,0,0}\n  ablock"));
+        a.expect(printed.ends_with(std::string(2 * 300, ' ') + "ablock {0,0,0,0} {0,0,0,0} {0,0,0,0}\n"));
     });
 
     s.add_test("anonymous block, get_property", [](etest::IActions &a) {
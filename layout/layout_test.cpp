@@ -44,7 +44,7 @@ void set_up_parent_ptrs(style::StyledNode &parent) {
 }
 
 // TODO(robinlinden): Remove.
-dom::Node create_element_node(std::string_view name, dom::AttrMap attrs, std::vector<dom::Node> children) {
+dom::Node create_element_node(std::string_view name, dom::AttrMap attrs, std::pmr::vector<dom::Node> children) {
     return dom::Element{std::string{name}, std::move(attrs), std::move(children)};
 }
 
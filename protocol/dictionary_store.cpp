@@ -0,0 +1,635 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "protocol/dictionary_store.h"
+
+#include "protocol/response.h"
+
+#include "uri/uri.h"
+#include "util/sha256.h"
+#include "util/string.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace std::literals;
+
+namespace protocol {
+namespace {
+
+// https://www.rfc-editor.org/rfc/rfc8941#name-tokens
+// Other bare items, like numbers, are kept as tokens as well, as nothing here
+// needs them.
+struct SfToken {
+    std::string value;
+};
+
+// https://www.rfc-editor.org/rfc/rfc8941#name-items, with any parameters ignored.
+using SfItem = std::variant<bool, std::string, SfToken>;
+
+// https://www.rfc-editor.org/rfc/rfc8941#name-inner-lists
+using SfInnerList = std::vector<SfItem>;
+
+using SfValue = std::variant<bool, std::string, SfToken, SfInnerList>;
+using SfDictionary = std::map<std::string, SfValue, std::less<>>;
+
+// https://www.rfc-editor.org/rfc/rfc8941#name-dictionaries
+// Only the parts needed for Use-As-Dictionary are supported.
+class SfDictionaryParser {
+public:
+    explicit SfDictionaryParser(std::string_view input) : input_{input} {}
+
+    std::optional<SfDictionary> parse() {
+        SfDictionary members;
+        skip_whitespace();
+        while (!is_eof()) {
+            auto key = parse_key();
+            if (!key) {
+                return std::nullopt;
+            }
+
+            SfValue value = true;
+            if (consume('=')) {
+                auto parsed = parse_item_or_inner_list();
+                if (!parsed) {
+                    return std::nullopt;
+                }
+
+                value = *std::move(parsed);
+            }
+
+            if (!skip_parameters()) {
+                return std::nullopt;
+            }
+
+            members.insert_or_assign(std::string{*key}, std::move(value));
+
+            skip_whitespace();
+            if (is_eof()) {
+                break;
+            }
+
+            if (!consume(',')) {
+                return std::nullopt;
+            }
+
+            skip_whitespace();
+            // Trailing commas aren't allowed.
+            if (is_eof()) {
+                return std::nullopt;
+            }
+        }
+
+        return members;
+    }
+
+private:
+    std::string_view input_;
+    std::size_t pos_{0};
+
+    bool is_eof() const { return pos_ >= input_.size(); }
+    char peek() const { return is_eof() ? '\0' : input_[pos_]; }
+
+    bool consume(char c) {
+        if (is_eof() || input_[pos_] != c) {
+            return false;
+        }
+
+        ++pos_;
+        return true;
+    }
+
+    void skip_whitespace() {
+        while (peek() == ' ' || peek() == '\t') {
+            ++pos_;
+        }
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc8941#name-parsing-a-key
+    std::optional<std::string_view> parse_key() {
+        auto end = std::min(input_.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789_-.*", pos_), input_.size());
+        auto key = input_.substr(pos_, end - pos_);
+        if (key.empty() || !(util::is_lower_alpha(key[0]) || key[0] == '*')) {
+            return std::nullopt;
+        }
+
+        pos_ = end;
+        return key;
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc8941#name-parsing-an-item-or-inner-li
+    std::optional<SfValue> parse_item_or_inner_list() {
+        if (peek() == '(') {
+            auto list = parse_inner_list();
+            if (!list) {
+                return std::nullopt;
+            }
+
+            return SfValue{*std::move(list)};
+        }
+
+        auto item = parse_bare_item();
+        if (!item) {
+            return std::nullopt;
+        }
+
+        return std::visit([](auto &v) -> SfValue { return std::move(v); }, *item);
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc8941#name-parsing-a-bare-item
+    std::optional<SfItem> parse_bare_item() {
+        if (peek() == '"') {
+            auto string = parse_string();
+            if (!string) {
+                return std::nullopt;
+            }
+
+            return SfItem{*std::move(string)};
+        }
+
+        if (consume('?')) {
+            if (consume('0')) {
+                return SfItem{false};
+            }
+
+            if (consume('1')) {
+                return SfItem{true};
+            }
+
+            return std::nullopt;
+        }
+
+        auto end = std::min(input_.find_first_of(" \t\",;()=", pos_), input_.size());
+        if (end == pos_) {
+            return std::nullopt;
+        }
+
+        auto item = input_.substr(pos_, end - pos_);
+        pos_ = end;
+        return SfItem{SfToken{std::string{item}}};
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc8941#name-parsing-a-string
+    std::optional<std::string> parse_string() {
+        if (!consume('"')) {
+            return std::nullopt;
+        }
+
+        std::string string;
+        while (!is_eof()) {
+            char c = input_[pos_++];
+            if (c == '"') {
+                return string;
+            }
+
+            if (c == '\\') {
+                if (is_eof() || (peek() != '"' && peek() != '\\')) {
+                    return std::nullopt;
+                }
+
+                c = input_[pos_++];
+            } else if (c < 0x20 || c > 0x7e) {
+                return std::nullopt;
+            }
+
+            string += c;
+        }
+
+        return std::nullopt;
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc8941#name-parsing-an-inner-list
+    std::optional<SfInnerList> parse_inner_list() {
+        if (!consume('(')) {
+            return std::nullopt;
+        }
+
+        SfInnerList list;
+        while (true) {
+            while (peek() == ' ') {
+                ++pos_;
+            }
+
+            if (consume(')')) {
+                return list;
+            }
+
+            auto item = parse_bare_item();
+            if (!item || !skip_parameters()) {
+                return std::nullopt;
+            }
+
+            list.push_back(*std::move(item));
+
+            if (peek() != ' ' && peek() != ')') {
+                return std::nullopt;
+            }
+        }
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc8941#name-parsing-parameters
+    bool skip_parameters() {
+        while (consume(';')) {
+            while (peek() == ' ') {
+                ++pos_;
+            }
+
+            if (!parse_key()) {
+                return false;
+            }
+
+            if (consume('=') && !parse_bare_item()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+template<typename T>
+T const *member(SfDictionary const &dictionary, std::string_view key) {
+    auto it = dictionary.find(key);
+    return it != dictionary.end() ? std::get_if<T>(&it->second) : nullptr;
+}
+
+std::string base64_encode(std::span<std::uint8_t const> data) {
+    constexpr auto kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"sv;
+    std::string out;
+    std::size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        std::uint32_t const group = std::uint32_t{data[i]} << 16 | std::uint32_t{data[i + 1]} << 8 | data[i + 2];
+        out += kAlphabet[(group >> 18) & 0x3f];
+        out += kAlphabet[(group >> 12) & 0x3f];
+        out += kAlphabet[(group >> 6) & 0x3f];
+        out += kAlphabet[group & 0x3f];
+    }
+
+    if (i + 1 == data.size()) {
+        std::uint32_t const group = std::uint32_t{data[i]} << 16;
+        out += kAlphabet[(group >> 18) & 0x3f];
+        out += kAlphabet[(group >> 12) & 0x3f];
+        out += "==";
+    } else if (i + 2 == data.size()) {
+        std::uint32_t const group = std::uint32_t{data[i]} << 16 | std::uint32_t{data[i + 1]} << 8;
+        out += kAlphabet[(group >> 18) & 0x3f];
+        out += kAlphabet[(group >> 12) & 0x3f];
+        out += kAlphabet[(group >> 6) & 0x3f];
+        out += '=';
+    }
+
+    return out;
+}
+
+bool is_same_origin(uri::Uri const &a, uri::Uri const &b) {
+    return a.scheme == b.scheme && a.authority.host == b.authority.host && a.authority.port == b.authority.port;
+}
+
+// Matches a pattern where '*' matches any sequence of characters.
+bool wildcard_match(std::string_view pattern, std::string_view input) {
+    std::size_t p = 0;
+    std::size_t i = 0;
+    std::optional<std::size_t> last_star;
+    std::size_t last_star_input = 0;
+
+    while (i < input.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            last_star = p++;
+            last_star_input = i;
+        } else if (p < pattern.size() && pattern[p] == input[i]) {
+            ++p;
+            ++i;
+        } else if (last_star) {
+            p = *last_star + 1;
+            i = ++last_star_input;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+
+    return p == pattern.size();
+}
+
+// Whether the host is an IPv4 address in 127.0.0.0/8 written as four decimal
+// octets. Anything else, like 127.example.com, is looked up using DNS.
+bool is_loopback_ipv4(std::string_view host) {
+    auto octets = util::split(host, ".");
+    if (octets.size() != 4 || octets[0] != "127") {
+        return false;
+    }
+
+    return std::ranges::all_of(octets, [](std::string_view octet) {
+        unsigned value{};
+        auto const *end = octet.data() + octet.size();
+        auto [ptr, ec] = std::from_chars(octet.data(), end, value);
+        return !octet.empty() && ec == std::errc{} && ptr == end && value <= 255;
+    });
+}
+
+// Dictionaries are only stored and advertised where the responses and requests
+// can't be read or altered in transit, but plain http to the local machine is
+// allowed for testing.
+// https://www.rfc-editor.org/rfc/rfc9842#name-security-considerations
+bool is_trustworthy(uri::Uri const &uri) {
+    if (uri.scheme == "https") {
+        return true;
+    }
+
+    auto const &host = uri.authority.host;
+    return uri.scheme == "http" && (host == "localhost" || host == "[::1]" || is_loopback_ipv4(host));
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#name-delta-seconds
+std::optional<std::chrono::seconds> parse_delta_seconds(std::string_view value) {
+    // Larger values are treated as the largest value caches have to support.
+    static constexpr std::uint64_t kMaxDeltaSeconds = std::uint64_t{1} << 31;
+
+    std::uint64_t seconds{};
+    auto const *end = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), end, seconds);
+    if (value.empty() || ptr != end || (ec != std::errc{} && ec != std::errc::result_out_of_range)) {
+        return std::nullopt;
+    }
+
+    if (ec == std::errc::result_out_of_range) {
+        seconds = kMaxDeltaSeconds;
+    }
+
+    return std::chrono::seconds{std::min(seconds, kMaxDeltaSeconds)};
+}
+
+// How much longer the response will be fresh, if it's fresh at all.
+// https://www.rfc-editor.org/rfc/rfc9111#name-freshness
+//
+// Only max-age is supported, so responses relying on Expires or on heuristic
+// freshness aren't used as dictionaries.
+std::optional<std::chrono::seconds> remaining_freshness(Headers const &headers) {
+    auto cache_control = headers.get("Cache-Control");
+    if (!cache_control) {
+        return std::nullopt;
+    }
+
+    std::optional<std::chrono::seconds> max_age;
+    for (auto directive : util::split(*cache_control, ",")) {
+        auto [name, value] = util::split_once(util::trim(directive), '=');
+        name = util::trim(name);
+        if (util::no_case_compare(name, "no-store") || util::no_case_compare(name, "no-cache")) {
+            return std::nullopt;
+        }
+
+        if (util::no_case_compare(name, "max-age")) {
+            value = util::trim(value);
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                value = value.substr(1, value.size() - 2);
+            }
+
+            // An invalid max-age makes the response stale.
+            max_age = parse_delta_seconds(value);
+            if (!max_age) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    if (!max_age) {
+        return std::nullopt;
+    }
+
+    auto age = std::chrono::seconds{0};
+    if (auto age_header = headers.get("Age")) {
+        age = parse_delta_seconds(util::trim(*age_header)).value_or(age);
+    }
+
+    if (age >= *max_age) {
+        return std::nullopt;
+    }
+
+    return *max_age - age;
+}
+
+bool matches(SharedDictionary const &dictionary, uri::Uri const &uri) {
+    if (!is_same_origin(dictionary.uri, uri)) {
+        return false;
+    }
+
+    // A pattern without a query matches any query.
+    if (dictionary.match.contains('?')) {
+        return wildcard_match(dictionary.match, uri.query.empty() ? uri.path : uri.path + '?' + uri.query);
+    }
+
+    return wildcard_match(dictionary.match, uri.path);
+}
+
+} // namespace
+
+bool DictionaryStore::add(uri::Uri const &uri, Response const &response) {
+    if (!is_trustworthy(uri)) {
+        return false;
+    }
+
+    // Error pages aren't what the server meant to be used as dictionaries.
+    auto const status = response.status_line.status_code;
+    if (status < 200 || status >= 300) {
+        return false;
+    }
+
+    auto header = response.headers.get("Use-As-Dictionary");
+    if (!header) {
+        return false;
+    }
+
+    auto params = SfDictionaryParser{*header}.parse();
+    if (!params) {
+        return false;
+    }
+
+    // match and id have to be strings, and type a token.
+    // https://www.rfc-editor.org/rfc/rfc9842#name-use-as-dictionary
+    auto const *match = member<std::string>(*params, "match");
+    if (match == nullptr || match->empty()) {
+        return false;
+    }
+
+    // URLPattern regexp groups and named groups aren't supported.
+    if (match->find_first_of("(){}:") != std::string::npos) {
+        return false;
+    }
+
+    if (params->contains("type")) {
+        auto const *type = member<SfToken>(*params, "type");
+        if (type == nullptr || type->value != "raw") {
+            return false;
+        }
+    }
+
+    auto const *id = member<std::string>(*params, "id");
+    if (id == nullptr && params->contains("id")) {
+        return false;
+    }
+
+    // An empty or missing match-dest matches every destination.
+    std::vector<std::string> destinations;
+    if (params->contains("match-dest")) {
+        auto const *list = member<SfInnerList>(*params, "match-dest");
+        if (list == nullptr) {
+            return false;
+        }
+
+        for (auto const &item : *list) {
+            auto const *destination = std::get_if<std::string>(&item);
+            if (destination == nullptr) {
+                return false;
+            }
+
+            destinations.push_back(*destination);
+        }
+    }
+
+    auto freshness = remaining_freshness(response.headers);
+    if (!freshness) {
+        return false;
+    }
+
+    auto match_uri = uri::Uri::parse(*match, uri);
+    if (!match_uri || !is_same_origin(*match_uri, uri)) {
+        return false;
+    }
+
+    // Evicting everything else wouldn't make room for it.
+    if (max_entries_ == 0 || response.body.size() > max_bytes_) {
+        return false;
+    }
+
+    auto dictionary = std::make_shared<SharedDictionary>(SharedDictionary{
+            .uri = uri,
+            .match = match_uri->query.empty() ? match_uri->path : match_uri->path + '?' + match_uri->query,
+            .id = id != nullptr ? *id : "",
+            .destinations = std::move(destinations),
+            .hash = util::sha256(std::span{response.body}),
+            .data = response.body,
+            .expires = now_() + *freshness,
+    });
+
+    std::scoped_lock lock{mutex_};
+    auto const now = now_();
+    std::erase_if(entries_, [&](Entry const &e) {
+        if (now >= e.dictionary->expires
+                || (is_same_origin(e.dictionary->uri, dictionary->uri) && e.dictionary->match == dictionary->match)) {
+            bytes_ -= e.dictionary->data.size();
+            return true;
+        }
+
+        return false;
+    });
+
+    while (entries_.size() >= max_entries_ || bytes_ + dictionary->data.size() > max_bytes_) {
+        assert(!entries_.empty());
+        auto lru = std::ranges::min_element(entries_, {}, &Entry::last_used);
+        bytes_ -= lru->dictionary->data.size();
+        entries_.erase(lru);
+    }
+
+    bytes_ += dictionary->data.size();
+    entries_.push_back({std::move(dictionary), ++uses_});
+    return true;
+}
+
+std::shared_ptr<SharedDictionary const> DictionaryStore::find(uri::Uri const &uri, std::string_view destination) const {
+    auto const now = now_();
+    std::scoped_lock lock{mutex_};
+    Entry *best = nullptr;
+    for (auto &entry : entries_) {
+        auto const &dictionary = *entry.dictionary;
+        if (now >= dictionary.expires || !matches(dictionary, uri)) {
+            continue;
+        }
+
+        if (!dictionary.destinations.empty()
+                && std::ranges::find(dictionary.destinations, destination) == dictionary.destinations.end()) {
+            continue;
+        }
+
+        // Longest match wins, with ties going to the most recently stored one.
+        if (best == nullptr || dictionary.match.size() >= best->dictionary->match.size()) {
+            best = &entry;
+        }
+    }
+
+    if (best == nullptr) {
+        return nullptr;
+    }
+
+    best->last_used = ++uses_;
+    return best->dictionary;
+}
+
+std::shared_ptr<SharedDictionary const> DictionaryStore::find(
+        uri::Uri const &uri, std::span<std::uint8_t const, 32> hash) const {
+    // Any dictionary matching the uri will do, as a more specific one may have
+    // been stored after the request advertising this one was sent.
+    auto const now = now_();
+    std::scoped_lock lock{mutex_};
+    auto it = std::ranges::find_if(entries_, [&](Entry const &entry) {
+        return now < entry.dictionary->expires && std::ranges::equal(entry.dictionary->hash, hash)
+                && matches(*entry.dictionary, uri);
+    });
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+
+    it->last_used = ++uses_;
+    return it->dictionary;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9842#name-available-dictionary
+Headers DictionaryStore::request_headers(uri::Uri const &uri, std::string_view destination) const {
+    if (!is_trustworthy(uri)) {
+        return {};
+    }
+
+    auto dictionary = find(uri, destination);
+    if (!dictionary) {
+        return {};
+    }
+
+    Headers headers;
+    headers.add({"Accept-Encoding", "dcb, dcz, br, zstd, gzip, deflate"});
+    headers.add({"Available-Dictionary", ':' + base64_encode(dictionary->hash) + ':'});
+    if (!dictionary->id.empty()) {
+        std::string id = "\"";
+        for (char c : dictionary->id) {
+            if (c == '"' || c == '\\') {
+                id += '\\';
+            }
+
+            id += c;
+        }
+
+        headers.add({"Dictionary-ID", id + '"'});
+    }
+
+    return headers;
+}
+
+} // namespace protocol
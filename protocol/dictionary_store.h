@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef PROTOCOL_DICTIONARY_STORE_H_
+#define PROTOCOL_DICTIONARY_STORE_H_
+
+#include "protocol/response.h"
+
+#include "uri/uri.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace protocol {
+
+// https://www.rfc-editor.org/rfc/rfc9842#name-dictionary-storage
+struct SharedDictionary {
+    uri::Uri uri;
+    // The uri the dictionary applies to, as a path with '*' wildcards.
+    std::string match;
+    std::string id;
+    // The request destinations the dictionary is used for, or empty for all.
+    std::vector<std::string> destinations;
+    std::array<std::uint8_t, 32> hash{};
+    std::string data;
+    // When the response it came from stops being fresh.
+    std::chrono::steady_clock::time_point expires{};
+};
+
+// Stores dictionaries for Compression Dictionary Transport, keyed by the
+// origin and match pattern they apply to and looked up by either a request
+// uri or the hash a server referred to in a dcb- or dcz-encoded response.
+//
+// The store holds at most a fixed number of dictionaries and bytes, evicting
+// the least recently used dictionaries to make room for new ones. Dictionaries
+// are only used while the responses they came from are fresh.
+class DictionaryStore {
+public:
+    static constexpr std::size_t kDefaultMaxEntries = 64;
+    static constexpr std::size_t kDefaultMaxBytes = std::size_t{32} * 1024 * 1024;
+
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    explicit DictionaryStore(std::size_t max_entries = kDefaultMaxEntries,
+            std::size_t max_bytes = kDefaultMaxBytes,
+            Clock now = std::chrono::steady_clock::now)
+        : max_entries_{max_entries}, max_bytes_{max_bytes}, now_{std::move(now)} {}
+
+    // Stores the (decompressed) response body as a dictionary if the response
+    // is successful, fresh, and has a valid Use-As-Dictionary header. Returns
+    // whether it was stored. Nothing is stored or advertised over plain http
+    // unless the host is a loopback one.
+    bool add(uri::Uri const &, Response const &);
+
+    // Returns the dictionary with the most specific match pattern matching
+    // the uri and request destination, if any, and marks it as used.
+    // https://fetch.spec.whatwg.org/#concept-request-destination
+    [[nodiscard]] std::shared_ptr<SharedDictionary const> find(
+            uri::Uri const &, std::string_view destination = {}) const;
+    // Returns the dictionary matching the uri with the hash a response referred
+    // to, if any, and marks it as used. Dictionaries from other origins are
+    // never used.
+    [[nodiscard]] std::shared_ptr<SharedDictionary const> find(
+            uri::Uri const &, std::span<std::uint8_t const, 32> hash) const;
+
+    // Available-Dictionary, Dictionary-ID, and Accept-Encoding request headers
+    // advertising the dictionary for the uri, if any.
+    [[nodiscard]] Headers request_headers(uri::Uri const &, std::string_view destination = {}) const;
+
+private:
+    struct Entry {
+        std::shared_ptr<SharedDictionary const> dictionary;
+        std::uint64_t last_used{};
+    };
+
+    std::size_t max_entries_{};
+    std::size_t max_bytes_{};
+    Clock now_;
+
+    mutable std::mutex mutex_;
+    mutable std::vector<Entry> entries_;
+    mutable std::uint64_t uses_{};
+    std::size_t bytes_{};
+};
+
+} // namespace protocol
+
+#endif
@@ -0,0 +1,314 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "protocol/dictionary_store.h"
+
+#include "protocol/response.h"
+
+#include "etest/etest2.h"
+#include "uri/uri.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace {
+protocol::Response dictionary_response(std::string use_as_dictionary, std::string body = "dictionary") {
+    return protocol::Response{
+            .status_line{.status_code = 200},
+            .headers{{"Use-As-Dictionary", std::move(use_as_dictionary)}, {"Cache-Control", "max-age=3600"}},
+            .body = std::move(body),
+    };
+}
+
+uri::Uri parse(std::string uri) {
+    return uri::Uri::parse(std::move(uri)).value();
+}
+} // namespace
+
+int main() {
+    etest::Suite s{"DictionaryStore"};
+
+    s.add_test("no header", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        a.expect(!store.add(parse("https://example.com/a.html"), protocol::Response{.body = "hello"}));
+        a.expect_eq(store.find(parse("https://example.com/a.html")), nullptr);
+        a.expect_eq(store.request_headers(parse("https://example.com/a.html")).size(), std::size_t{0});
+    });
+
+    s.add_test("invalid headers", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        auto uri = parse("https://example.com/a.html");
+        a.expect(!store.add(uri, dictionary_response(R"(id="no-match")")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="")")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/unterminated)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*", type=other)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/:name")")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="https://other.example.com/*")")));
+        a.expect(!store.add(uri, dictionary_response(R"(Match="/*")")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*",)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*" id="a")")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*", match-dest=("document")")));
+
+        // match and id have to be strings, and type a token.
+        a.expect(!store.add(uri, dictionary_response(R"(match=/*)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match=a)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match=("/*"))")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*", id=dict)")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*", type="raw")")));
+    });
+
+    s.add_test("parameters and unknown members are ignored", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        auto uri = parse("https://example.com/a.html");
+        a.require(store.add(uri,
+                dictionary_response(R"(match="/*";a=1, id="dict";b, type=raw, ttl=3600, future=?1, list=(a "b" 1))")));
+        a.expect_eq(store.find(uri)->id, "dict");
+    });
+
+    s.add_test("error responses", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        auto uri = parse("https://example.com/a.html");
+        for (int status : {0, 101, 304, 404, 500}) {
+            auto response = dictionary_response(R"(match="/*")");
+            response.status_line.status_code = status;
+            a.expect(!store.add(uri, response));
+        }
+
+        a.expect_eq(store.find(uri), nullptr);
+    });
+
+    s.add_test("match", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        a.require(store.add(parse("https://example.com/product/1"),
+                dictionary_response(R"(match="/product/*", id="dict-1")")));
+
+        auto dictionary = store.find(parse("https://example.com/product/2?color=red"));
+        a.require(dictionary != nullptr);
+        a.expect_eq(dictionary->match, "/product/*");
+        a.expect_eq(dictionary->id, "dict-1");
+        a.expect_eq(dictionary->data, "dictionary");
+
+        a.expect_eq(store.find(parse("https://example.com/products")), nullptr);
+        a.expect_eq(store.find(parse("http://example.com/product/2")), nullptr);
+        a.expect_eq(store.find(parse("https://example.com:8080/product/2")), nullptr);
+        a.expect_eq(store.find(parse("https://www.example.com/product/2")), nullptr);
+    });
+
+    s.add_test("match-dest", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        auto uri = parse("https://example.com/");
+        a.require(store.add(uri, dictionary_response(R"(match="/*", match-dest=("document" "frame"))", "documents")));
+        a.require(store.add(uri, dictionary_response(R"(match="/s*", match-dest=())", "any")));
+
+        a.expect_eq(store.find(parse("https://example.com/page"), "document")->data, "documents");
+        a.expect_eq(store.find(parse("https://example.com/page"), "frame")->data, "documents");
+        a.expect_eq(store.find(parse("https://example.com/page"), "style"), nullptr);
+        a.expect_eq(store.find(parse("https://example.com/page")), nullptr);
+        a.expect_eq(store.find(parse("https://example.com/style.css"), "style")->data, "any");
+        a.expect_eq(store.request_headers(parse("https://example.com/page"), "image").size(), std::size_t{0});
+        a.expect_eq(store.request_headers(parse("https://example.com/page"), "document").size(), std::size_t{2});
+
+        // Destinations have to be strings.
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*", match-dest=(document))")));
+        a.expect(!store.add(uri, dictionary_response(R"(match="/*", match-dest="document")")));
+    });
+
+    s.add_test("expiry", [](etest::IActions &a) {
+        auto now = std::chrono::steady_clock::time_point{};
+        protocol::DictionaryStore store{8, 1024, [&now] { return now; }};
+        auto response = [](std::string cache_control, std::string age = "") {
+            auto r = dictionary_response(R"(match="/*")");
+            r.headers = {{"Use-As-Dictionary", R"(match="/*")"}, {"Cache-Control", std::move(cache_control)}};
+            if (!age.empty()) {
+                r.headers.add({"Age", age});
+            }
+            return r;
+        };
+
+        a.require(store.add(parse("https://a.example.com/"), response("public, max-age=60")));
+        a.require(store.add(parse("https://b.example.com/"), response("max-age=\"120\"", "30")));
+        auto a_dictionary = store.find(parse("https://a.example.com/"));
+        a.require(a_dictionary != nullptr);
+
+        now += std::chrono::seconds{59};
+        a.expect(store.find(parse("https://a.example.com/")) != nullptr);
+        now += std::chrono::seconds{1};
+        a.expect_eq(store.find(parse("https://a.example.com/")), nullptr);
+        a.expect_eq(store.find(parse("https://a.example.com/"), a_dictionary->hash), nullptr);
+        a.expect_eq(store.request_headers(parse("https://a.example.com/")).size(), std::size_t{0});
+
+        // b was already 30 seconds old when it was stored.
+        now += std::chrono::seconds{29};
+        a.expect(store.find(parse("https://b.example.com/")) != nullptr);
+        now += std::chrono::seconds{1};
+        a.expect_eq(store.find(parse("https://b.example.com/")), nullptr);
+
+        // Responses that aren't fresh aren't stored at all.
+        for (auto const *cache_control : {"", "public", "max-age=0", "max-age=abc", "max-age=60, no-store",
+                     "no-cache, max-age=60"}) {
+            a.expect(!store.add(parse("https://c.example.com/"), response(cache_control)));
+        }
+
+        a.expect(!store.add(parse("https://c.example.com/"), response("max-age=60", "60")));
+        auto no_cache_control = dictionary_response(R"(match="/*")");
+        no_cache_control.headers = {{"Use-As-Dictionary", R"(match="/*")"}};
+        a.expect(!store.add(parse("https://c.example.com/"), no_cache_control));
+    });
+
+    s.add_test("expired dictionaries are evicted first", [](etest::IActions &a) {
+        auto now = std::chrono::steady_clock::time_point{};
+        protocol::DictionaryStore store{2, 1024, [&now] { return now; }};
+        auto short_lived = dictionary_response(R"(match="/*")");
+        short_lived.headers = {{"Use-As-Dictionary", R"(match="/*")"}, {"Cache-Control", "max-age=1"}};
+        a.require(store.add(parse("https://a.example.com/"), short_lived));
+        a.require(store.add(parse("https://b.example.com/"), dictionary_response(R"(match="/*")")));
+
+        // a is expired, so it's evicted instead of the least recently used b.
+        a.require(store.find(parse("https://a.example.com/")) != nullptr);
+        now += std::chrono::seconds{1};
+        a.require(store.add(parse("https://c.example.com/"), dictionary_response(R"(match="/*")")));
+        a.expect(store.find(parse("https://b.example.com/")) != nullptr);
+        a.expect(store.find(parse("https://c.example.com/")) != nullptr);
+    });
+
+    s.add_test("relative match", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        a.require(store.add(parse("https://example.com/js/app.v1.js"), dictionary_response(R"(match="app.*.js")")));
+
+        a.expect(store.find(parse("https://example.com/js/app.v2.js")) != nullptr);
+        a.expect_eq(store.find(parse("https://example.com/app.v2.js")), nullptr);
+        a.expect_eq(store.find(parse("https://example.com/js/app.v2.css")), nullptr);
+    });
+
+    s.add_test("longest match wins", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        auto uri = parse("https://example.com/");
+        a.require(store.add(uri, dictionary_response(R"(match="/*")", "short")));
+        a.require(store.add(uri, dictionary_response(R"(match="/news/*")", "long")));
+        a.require(store.add(uri, dictionary_response(R"(match="/*")", "replaced")));
+
+        a.expect_eq(store.find(parse("https://example.com/news/1"))->data, "long");
+        a.expect_eq(store.find(parse("https://example.com/sport/1"))->data, "replaced");
+        a.expect_eq(store.find(parse("https://example.com/"))->data, "replaced");
+    });
+
+    s.add_test("find by hash", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        a.require(store.add(parse("https://example.com/"), dictionary_response(R"(match="/*")")));
+
+        auto dictionary = store.find(parse("https://example.com/"));
+        a.require(dictionary != nullptr);
+        a.expect_eq(store.find(parse("https://example.com/a"), dictionary->hash), dictionary);
+        a.expect_eq(store.find(parse("https://example.com/a"), std::array<std::uint8_t, 32>{}), nullptr);
+
+        // The same dictionary can't be used by other origins.
+        a.expect_eq(store.find(parse("https://example.net/a"), dictionary->hash), nullptr);
+    });
+
+    s.add_test("find by hash, more specific dictionary stored since", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        a.require(store.add(parse("https://example.com/"), dictionary_response(R"(match="/*")", "general")));
+        auto advertised = store.find(parse("https://example.com/news/1"));
+        a.require(advertised != nullptr);
+
+        // Stored while the request advertising the general one was in flight.
+        a.require(store.add(parse("https://example.com/news/"), dictionary_response(R"(match="/news/*")", "news")));
+        a.expect_eq(store.find(parse("https://example.com/news/1"))->data, "news");
+        a.expect_eq(store.find(parse("https://example.com/news/1"), advertised->hash), advertised);
+    });
+
+    s.add_test("find by hash marks the dictionary as used", [](etest::IActions &a) {
+        protocol::DictionaryStore store{2, 1024};
+        a.require(store.add(parse("https://a.example.com/"), dictionary_response(R"(match="/*")")));
+        a.require(store.add(parse("https://b.example.com/"), dictionary_response(R"(match="/*")", "b")));
+
+        auto a_dictionary = store.find(parse("https://a.example.com/"));
+        a.require(a_dictionary != nullptr);
+        a.require(store.find(parse("https://b.example.com/")) != nullptr);
+
+        // Using a by hash makes b the least recently used dictionary.
+        a.require(store.find(parse("https://a.example.com/"), a_dictionary->hash) != nullptr);
+        a.require(store.add(parse("https://c.example.com/"), dictionary_response(R"(match="/*")")));
+        a.expect(store.find(parse("https://a.example.com/")) != nullptr);
+        a.expect_eq(store.find(parse("https://b.example.com/")), nullptr);
+    });
+
+    s.add_test("request headers", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        // echo -n dictionary | sha256sum | xxd -r -p | base64
+        a.require(store.add(parse("https://example.com/"), dictionary_response(R"(match="/*", id="a \"b\"")")));
+
+        auto headers = store.request_headers(parse("https://example.com/page"));
+        a.expect_eq(headers.get("Available-Dictionary"), ":F3ynD0Le8SOONtoylHMmPtP+rdFAlMB5oiML4Bk0NvU=:");
+        a.expect_eq(headers.get("Dictionary-ID"), R"("a \"b\"")");
+        a.expect(headers.get("Accept-Encoding")->contains("dcz"));
+    });
+
+    s.add_test("least recently used dictionaries are evicted", [](etest::IActions &a) {
+        protocol::DictionaryStore store{2, 20};
+        a.require(store.add(parse("https://a.example.com/"), dictionary_response(R"(match="/*")")));
+        a.require(store.add(parse("https://b.example.com/"), dictionary_response(R"(match="/*")")));
+
+        // Using a makes b the least recently used dictionary.
+        a.require(store.find(parse("https://a.example.com/page")) != nullptr);
+        a.require(store.add(parse("https://c.example.com/"), dictionary_response(R"(match="/*")")));
+        a.expect(store.find(parse("https://a.example.com/page")) != nullptr);
+        a.expect_eq(store.find(parse("https://b.example.com/page")), nullptr);
+        a.expect(store.find(parse("https://c.example.com/page")) != nullptr);
+
+        // Too many bytes evicts dictionaries as well.
+        a.require(store.add(parse("https://d.example.com/"), dictionary_response(R"(match="/*")", "large dictionary")));
+        a.expect_eq(store.find(parse("https://a.example.com/page")), nullptr);
+        a.expect_eq(store.find(parse("https://c.example.com/page")), nullptr);
+        a.expect(store.find(parse("https://d.example.com/page")) != nullptr);
+
+        // Dictionaries that won't fit aren't stored.
+        auto too_large = dictionary_response(R"(match="/*")", std::string(21, 'a'));
+        a.expect(!store.add(parse("https://e.example.com/"), too_large));
+        a.expect(store.find(parse("https://d.example.com/page")) != nullptr);
+    });
+
+    s.add_test("dictionaries that can never fit aren't stored", [](etest::IActions &a) {
+        protocol::DictionaryStore no_entries{0, 1024};
+        a.expect(!no_entries.add(parse("https://example.com/"), dictionary_response(R"(match="/*")")));
+        a.expect_eq(no_entries.find(parse("https://example.com/")), nullptr);
+
+        protocol::DictionaryStore no_bytes{8, 0};
+        a.expect(!no_bytes.add(parse("https://example.com/"), dictionary_response(R"(match="/*")")));
+        a.expect_eq(no_bytes.find(parse("https://example.com/")), nullptr);
+
+        // Rejecting a dictionary doesn't evict the ones already stored.
+        protocol::DictionaryStore store{8, 10};
+        a.require(store.add(parse("https://a.example.com/"), dictionary_response(R"(match="/*")", "small")));
+        a.expect(!store.add(parse("https://b.example.com/"), dictionary_response(R"(match="/*")", "much too large")));
+        a.expect(store.find(parse("https://a.example.com/")) != nullptr);
+        a.expect_eq(store.find(parse("https://b.example.com/")), nullptr);
+    });
+
+    s.add_test("cleartext", [](etest::IActions &a) {
+        protocol::DictionaryStore store;
+        for (auto const *origin :
+                {"http://example.com", "http://127.example.com", "http://127.0.0.1.example.com", "http://[::2]"}) {
+            auto uri = parse(std::string{origin} + "/");
+            a.expect(!store.add(uri, dictionary_response(R"(match="/*")")));
+            a.expect_eq(store.find(uri), nullptr);
+            a.expect_eq(store.request_headers(uri).size(), std::size_t{0});
+        }
+
+        // Loopback hosts are fine so that local servers can be tested against.
+        for (auto const *origin : {"http://localhost", "http://127.0.0.1", "http://127.1.2.3", "http://[::1]"}) {
+            auto uri = parse(std::string{origin} + "/");
+            a.require(store.add(uri, dictionary_response(R"(match="/*")")));
+            a.expect(store.request_headers(uri).get("Available-Dictionary").has_value());
+        }
+    });
+
+    return s.run();
+}
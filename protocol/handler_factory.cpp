@@ -4,6 +4,7 @@
 
 #include "protocol/handler_factory.h"
 
+#include "protocol/dictionary_store.h"
 #include "protocol/file_handler.h"
 #include "protocol/http_handler.h"
 #include "protocol/https_handler.h"
@@ -15,10 +16,11 @@
 
 namespace protocol {
 
-std::unique_ptr<MultiProtocolHandler> HandlerFactory::create(std::optional<std::string> user_agent) {
+std::unique_ptr<MultiProtocolHandler> HandlerFactory::create(
+        std::optional<std::string> user_agent, std::shared_ptr<DictionaryStore const> dictionaries) {
     auto handler = std::make_unique<MultiProtocolHandler>();
-    handler->add("http", std::make_unique<HttpHandler>(user_agent));
-    handler->add("https", std::make_unique<HttpsHandler>(std::move(user_agent)));
+    handler->add("http", std::make_unique<HttpHandler>(user_agent, dictionaries));
+    handler->add("https", std::make_unique<HttpsHandler>(std::move(user_agent), std::move(dictionaries)));
     handler->add("file", std::make_unique<FileHandler>());
     return handler;
 }
@@ -5,6 +5,7 @@
 #ifndef PROTOCOL_HANDLER_FACTORY_H_
 #define PROTOCOL_HANDLER_FACTORY_H_
 
+#include "protocol/dictionary_store.h"
 #include "protocol/multi_protocol_handler.h"
 
 #include <memory>
@@ -15,8 +16,11 @@ namespace protocol {
 
 class HandlerFactory {
 public:
+    // If a dictionary store is provided, http(s) requests advertise any
+    // dictionaries matching the requested uri.
     [[nodiscard]] static std::unique_ptr<MultiProtocolHandler> create(
-            std::optional<std::string> user_agent = std::nullopt);
+            std::optional<std::string> user_agent = std::nullopt,
+            std::shared_ptr<DictionaryStore const> dictionaries = nullptr);
 };
 
 } // namespace protocol
@@ -39,7 +39,8 @@ bool Http::use_port(uri::Uri const &uri) {
     return true;
 }
 
-std::string Http::create_get_request(uri::Uri const &uri, std::optional<std::string_view> user_agent) {
+std::string Http::create_get_request(
+        uri::Uri const &uri, std::optional<std::string_view> user_agent, Headers const &request_headers) {
     std::stringstream ss;
     ss << std::format("GET {}", uri.path);
     if (!uri.query.empty()) {
@@ -59,6 +60,10 @@ std::string Http::create_get_request(uri::Uri const &uri, std::optional<std::str
         ss << std::format("User-Agent: {}\r\n", *user_agent);
     }
 
+    for (auto const &[name, value] : request_headers) {
+        ss << std::format("{}: {}\r\n", name, value);
+    }
+
     ss << "\r\n";
 
     return std::move(ss).str();
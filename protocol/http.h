@@ -25,15 +25,17 @@ namespace protocol {
 
 class Http {
 public:
-    static tl::expected<Response, Error> get(
-            auto &&socket, uri::Uri const &uri, std::optional<std::string_view> user_agent) {
+    static tl::expected<Response, Error> get(auto &&socket,
+            uri::Uri const &uri,
+            std::optional<std::string_view> user_agent,
+            Headers const &request_headers = {}) {
         using namespace std::string_view_literals;
 
         if (!socket.connect(uri.authority.host, Http::use_port(uri) ? uri.authority.port : uri.scheme)) {
             return tl::unexpected{Error{ErrorCode::Unresolved}};
         }
 
-        socket.write(Http::create_get_request(uri, std::move(user_agent)));
+        socket.write(Http::create_get_request(uri, std::move(user_agent), request_headers));
         auto data = socket.read_until("\r\n"sv);
         if (data.empty()) {
             return tl::unexpected{Error{ErrorCode::InvalidResponse}};
@@ -117,7 +119,8 @@ private:
     }
 
     static bool use_port(uri::Uri const &uri);
-    static std::string create_get_request(uri::Uri const &uri, std::optional<std::string_view> user_agent);
+    static std::string create_get_request(
+            uri::Uri const &uri, std::optional<std::string_view> user_agent, Headers const &request_headers);
     static std::optional<StatusLine> parse_status_line(std::string_view status_line);
     static Headers parse_headers(std::string_view header);
 };
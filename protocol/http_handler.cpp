@@ -6,15 +6,22 @@
 #include "protocol/http_handler.h"
 
 #include "net/socket.h"
+#include "protocol/dictionary_store.h"
 #include "protocol/http.h"
 #include "protocol/response.h"
 #include "uri/uri.h"
 
 #include <tl/expected.hpp>
 
+#include <string_view>
+
 namespace protocol {
 
-tl::expected<Response, Error> HttpHandler::handle(uri::Uri const &uri) {
+tl::expected<Response, Error> HttpHandler::handle_for_destination(uri::Uri const &uri, std::string_view destination) {
+    if (dictionaries_) {
+        return Http::get(net::Socket{}, uri, user_agent_, dictionaries_->request_headers(uri, destination));
+    }
+
     return Http::get(net::Socket{}, uri, user_agent_);
 }
 
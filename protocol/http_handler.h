@@ -5,6 +5,7 @@
 #ifndef PROTOCOL_HTTP_HANDLER_H_
 #define PROTOCOL_HTTP_HANDLER_H_
 
+#include "protocol/dictionary_store.h"
 #include "protocol/iprotocol_handler.h"
 #include "protocol/response.h"
 
@@ -12,20 +13,30 @@
 
 #include <tl/expected.hpp>
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace protocol {
 
 class HttpHandler final : public IProtocolHandler {
 public:
-    explicit HttpHandler(std::optional<std::string> user_agent) : user_agent_{std::move(user_agent)} {}
+    explicit HttpHandler(std::optional<std::string> user_agent,
+            std::shared_ptr<DictionaryStore const> dictionaries = nullptr)
+        : user_agent_{std::move(user_agent)}, dictionaries_{std::move(dictionaries)} {}
 
-    [[nodiscard]] tl::expected<Response, Error> handle(uri::Uri const &) override;
+    [[nodiscard]] tl::expected<Response, Error> handle(uri::Uri const &uri) override {
+        return handle_for_destination(uri, {});
+    }
+
+    [[nodiscard]] tl::expected<Response, Error> handle_for_destination(
+            uri::Uri const &, std::string_view destination) override;
 
 private:
     std::optional<std::string> user_agent_;
+    std::shared_ptr<DictionaryStore const> dictionaries_;
 };
 
 } // namespace protocol
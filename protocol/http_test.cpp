@@ -328,6 +328,13 @@ int main() {
         a.expect(socket.write_data.find("User-Agent: test-agent\r\n") == std::string::npos);
     });
 
+    s.add_test("request headers are included", [](etest::IActions &a) {
+        FakeSocket socket{};
+        std::ignore = protocol::Http::get(socket, create_uri(), std::nullopt, {{"Available-Dictionary", ":abc=:"}});
+        a.expect(socket.write_data.find("Available-Dictionary: :abc=:\r\n") != std::string::npos);
+        a.expect(socket.write_data.ends_with("\r\n\r\n"));
+    });
+
     s.add_test("truncated status line", [](etest::IActions &a) {
         FakeSocket socket{.read_data = "HTTP/1.1 200\r\n"};
         auto response = protocol::Http::get(socket, create_uri(), std::nullopt).error();
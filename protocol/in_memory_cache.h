@@ -15,6 +15,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string_view>
 #include <utility>
 
 namespace protocol {
@@ -25,6 +26,12 @@ public:
     explicit InMemoryCache(std::unique_ptr<IProtocolHandler> handler) : handler_{std::move(handler)} {}
 
     [[nodiscard]] tl::expected<Response, Error> handle(uri::Uri const &uri) override {
+        return handle_for_destination(uri, {});
+    }
+
+    // Responses are cached by uri only, no matter what they were requested for.
+    [[nodiscard]] tl::expected<Response, Error> handle_for_destination(
+            uri::Uri const &uri, std::string_view destination) override {
         {
             std::scoped_lock lock{cache_mutex_};
             if (auto it = cache_.find(uri); it != cend(cache_)) {
@@ -32,7 +39,7 @@ public:
             }
         }
 
-        auto response = handler_->handle(uri);
+        auto response = handler_->handle_for_destination(uri, destination);
         std::scoped_lock lock{cache_mutex_};
         return cache_[uri] = std::move(response);
     }
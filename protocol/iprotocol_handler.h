@@ -11,12 +11,22 @@
 
 #include <tl/expected.hpp>
 
+#include <string_view>
+
 namespace protocol {
 
 class IProtocolHandler {
 public:
     virtual ~IProtocolHandler() = default;
     [[nodiscard]] virtual tl::expected<Response, Error> handle(uri::Uri const &) = 0;
+
+    // Handles a request where what's being requested, e.g. a "document" or a
+    // "style", is known, for handlers whose requests depend on that.
+    // https://fetch.spec.whatwg.org/#concept-request-destination
+    [[nodiscard]] virtual tl::expected<Response, Error> handle_for_destination(
+            uri::Uri const &uri, std::string_view /*destination*/) {
+        return handle(uri);
+    }
 };
 
 } // namespace protocol
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace protocol {
@@ -32,6 +33,15 @@ public:
         return tl::unexpected{Error{ErrorCode::Unhandled}};
     }
 
+    [[nodiscard]] tl::expected<Response, Error> handle_for_destination(
+            uri::Uri const &uri, std::string_view destination) override {
+        if (auto it = handlers_.find(uri.scheme); it != handlers_.end()) {
+            return it->second->handle_for_destination(uri, destination);
+        }
+
+        return tl::unexpected{Error{ErrorCode::Unhandled}};
+    }
+
 private:
     std::map<std::string, std::unique_ptr<IProtocolHandler>, std::less<>> handlers_;
 };
@@ -13,6 +13,8 @@
 #include <tl/expected.hpp>
 
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 
 using protocol::MultiProtocolHandler;
@@ -30,6 +32,18 @@ private:
     tl::expected<protocol::Response, protocol::Error> response_;
 };
 
+class DestinationProtocolHandler final : public protocol::IProtocolHandler {
+public:
+    [[nodiscard]] tl::expected<protocol::Response, protocol::Error> handle(uri::Uri const &) override {
+        return protocol::Response{};
+    }
+
+    [[nodiscard]] tl::expected<protocol::Response, protocol::Error> handle_for_destination(
+            uri::Uri const &, std::string_view destination) override {
+        return protocol::Response{.body = std::string{destination}};
+    }
+};
+
 } // namespace
 
 int main() {
@@ -44,5 +58,15 @@ int main() {
         a.expect_eq(handler.handle(uri::Uri{.scheme = "hax"}), protocol::Response{});
     });
 
+    s.add_test("destinations are forwarded", [](etest::IActions &a) {
+        MultiProtocolHandler handler;
+        a.expect_eq(handler.handle_for_destination(uri::Uri{.scheme = "hax"}, "style"),
+                tl::unexpected{protocol::Error{protocol::ErrorCode::Unhandled}});
+
+        handler.add("hax", std::make_unique<DestinationProtocolHandler>());
+        a.expect_eq(handler.handle_for_destination(uri::Uri{.scheme = "hax"}, "style"),
+                protocol::Response{.body = "style"});
+    });
+
     return s.run();
 }
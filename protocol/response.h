@@ -44,6 +44,9 @@ public:
     [[nodiscard]] std::string to_string() const;
     [[nodiscard]] std::size_t size() const;
 
+    [[nodiscard]] auto begin() const { return headers_.cbegin(); }
+    [[nodiscard]] auto end() const { return headers_.cend(); }
+
     [[nodiscard]] bool operator==(Headers const &) const = default;
 
 private:
@@ -122,12 +122,12 @@ std::optional<std::string_view> get_image_id(layout::LayoutBox const &layout) {
     assert(!layout.is_anonymous_block());
     auto const *img = std::get_if<dom::Element>(&layout.node->node);
     // TODO(robinlinden): Allow images for `display: block` once hooked up in the layout system.
-    if (img == nullptr || img->name != "img"
+    if (img == nullptr || img->name != dom::Atom::known("img")
             || layout.get_property<css::PropertyId::Display>() == style::Display::block_flow()) {
         return {};
     }
 
-    auto src = img->attributes.find("src");
+    auto src = img->attributes.find(dom::Atom::known("src"));
     if (src == img->attributes.end()) {
         return {};
     }
@@ -173,8 +173,10 @@ void render_layout(gfx::ICanvas &painter,
         layout::LayoutBox const &layout,
         std::optional<geom::Rect> const &clip,
         ImageLookupFn const &image_lookup) {
-    static constexpr auto kGetBg = [](std::string_view xpath, layout::LayoutBox const &l) -> std::optional<gfx::Color> {
-        auto d = dom::nodes_by_xpath(l, xpath);
+    static auto const kHtml = *dom::XPath::parse("/html");
+    static auto const kBody = *dom::XPath::parse("/html/body");
+    static constexpr auto kGetBg = [](dom::XPath const &path, layout::LayoutBox const &l) -> std::optional<gfx::Color> {
+        auto d = dom::nodes_by_xpath(l, path);
         if (d.empty()) {
             return std::nullopt;
         }
@@ -184,10 +186,9 @@ void render_layout(gfx::ICanvas &painter,
 
     // https://www.w3.org/TR/css-backgrounds-3/#special-backgrounds
     // If html or body has a background set, use that as the canvas background.
-    if (auto html_bg = kGetBg("/html", layout); html_bg && html_bg != gfx::Color::from_css_name("transparent")) {
+    if (auto html_bg = kGetBg(kHtml, layout); html_bg && html_bg != gfx::Color::from_css_name("transparent")) {
         painter.clear(*html_bg);
-    } else if (auto body_bg = kGetBg("/html/body", layout);
-            body_bg && body_bg != gfx::Color::from_css_name("transparent")) {
+    } else if (auto body_bg = kGetBg(kBody, layout); body_bg && body_bg != gfx::Color::from_css_name("transparent")) {
         painter.clear(*body_bg);
     } else {
         painter.clear(gfx::Color{255, 255, 255});
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "style/ancestor_filter.h"
+
+#include "style/selector.h"
+
+#include "dom/atom.h"
+#include "dom/dom.h"
+#include "util/string.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace style {
+namespace {
+
+// Salts so that e.g. the tag "a" and the class "a" don't share counters.
+constexpr std::uint64_t kTagSalt = 0x9e37'79b9'7f4a'7c15;
+constexpr std::uint64_t kIdSalt = 0xc2b2'ae3d'27d4'eb4f;
+constexpr std::uint64_t kClassSalt = 0x1656'67b1'9e37'79f9;
+
+// The splitmix64 finalizer. Atoms are hashed by address, and std::hash
+// for pointers is the identity in some standard libraries, so the input can't
+// be used as is.
+constexpr std::uint32_t mix(std::uint64_t hash, std::uint64_t salt) {
+    hash ^= salt;
+    hash ^= hash >> 30;
+    hash *= 0xbf58'476d'1ce4'e5b9;
+    hash ^= hash >> 27;
+    hash *= 0x94d0'49bb'1331'11eb;
+    hash ^= hash >> 31;
+    return static_cast<std::uint32_t>(hash);
+}
+
+template<typename F>
+void for_each_hash(dom::Element const &element, F &&f) {
+    f(tag_hash(element.name));
+
+    if (auto id = element.attributes.find(dom::Atom::known("id")); id != element.attributes.end()) {
+        f(id_hash(id->second));
+    }
+
+    if (auto cls = element.attributes.find(dom::Atom::known("class")); cls != element.attributes.end()) {
+        util::for_each_ascii_whitespace_split(cls->second, [&](std::string_view c) { f(class_hash(c)); });
+    }
+}
+
+} // namespace
+
+std::uint32_t tag_hash(dom::Atom const &tag) {
+    return mix(std::hash<dom::Atom>{}(tag), kTagSalt);
+}
+
+std::uint32_t id_hash(std::string_view id) {
+    return mix(std::hash<std::string_view>{}(id), kIdSalt);
+}
+
+std::uint32_t class_hash(std::string_view cls) {
+    return mix(std::hash<std::string_view>{}(cls), kClassSalt);
+}
+
+void AncestorFilter::push(dom::Element const &element) {
+    for_each_hash(element, [this](std::uint32_t hash) { insert(hash); });
+}
+
+void AncestorFilter::pop(dom::Element const &element) {
+    for_each_hash(element, [this](std::uint32_t hash) { remove(hash); });
+}
+
+bool AncestorFilter::might_contain(std::uint32_t hash) const {
+    return counters_[hash & kKeyMask] != 0 && counters_[(hash >> kKeyBits) & kKeyMask] != 0;
+}
+
+bool AncestorFilter::might_match(Selector const &selector) const {
+    return std::ranges::all_of(selector.ancestor_hashes(), [this](std::uint32_t hash) { return might_contain(hash); });
+}
+
+void AncestorFilter::insert(std::uint32_t hash) {
+    for (auto key : {hash & kKeyMask, (hash >> kKeyBits) & kKeyMask}) {
+        auto &counter = counters_[key];
+        if (counter != kMaxCount) {
+            ++counter;
+        }
+    }
+}
+
+void AncestorFilter::remove(std::uint32_t hash) {
+    for (auto key : {hash & kKeyMask, (hash >> kKeyBits) & kKeyMask}) {
+        auto &counter = counters_[key];
+        if (counter != kMaxCount) {
+            --counter;
+        }
+    }
+}
+
+} // namespace style
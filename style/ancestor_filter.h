@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef STYLE_ANCESTOR_FILTER_H_
+#define STYLE_ANCESTOR_FILTER_H_
+
+#include "style/selector.h"
+
+#include "dom/atom.h"
+#include "dom/dom.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace style {
+
+// Hashes of the things a selector can require an ancestor to have.
+[[nodiscard]] std::uint32_t tag_hash(dom::Atom const &);
+[[nodiscard]] std::uint32_t id_hash(std::string_view);
+[[nodiscard]] std::uint32_t class_hash(std::string_view);
+
+// A counting Bloom filter of the tags, ids, and classes of the ancestors of the
+// element currently being styled, maintained by pushing elements on the way
+// down the tree and popping them on the way back up.
+//
+// It's used to reject selectors like ".a .b" without walking up the tree when
+// no ancestor has the class "a". False positives are possible, so selectors
+// that pass still need to be matched properly, but a selector is never
+// rejected if it could match.
+class AncestorFilter {
+public:
+    void push(dom::Element const &);
+    // Must be called with the same element that was pushed last.
+    void pop(dom::Element const &);
+
+    [[nodiscard]] bool might_contain(std::uint32_t hash) const;
+    [[nodiscard]] bool might_match(Selector const &) const;
+
+private:
+    void insert(std::uint32_t hash);
+    void remove(std::uint32_t hash);
+
+    // Two counters per hash, each picked using 12 bits of it, as in Blink and
+    // Servo. This keeps the false positive rate low for the number of
+    // ancestors real pages have while fitting in 4kB.
+    static constexpr std::size_t kKeyBits = 12;
+    static constexpr std::uint32_t kKeyMask = (1U << kKeyBits) - 1;
+    // Counters that reach the max value stay there, as we don't know how many
+    // elements contributed to them anymore.
+    static constexpr std::uint8_t kMaxCount = 0xff;
+
+    std::array<std::uint8_t, std::size_t{1} << kKeyBits> counters_{};
+};
+
+} // namespace style
+
+#endif
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "style/ancestor_filter.h"
+
+#include "style/selector.h"
+
+#include "dom/atom.h"
+#include "dom/dom.h"
+#include "etest/etest2.h"
+
+#include <cstddef>
+
+using style::AncestorFilter;
+using style::Selector;
+
+int main() {
+    etest::Suite s{"AncestorFilter"};
+
+    s.add_test("push and pop", [](etest::IActions &a) {
+        dom::Element div{"div", {{"id", "a"}, {"class", " b\tc "}}};
+        dom::Element p{"p", {{"class", "c"}}};
+        AncestorFilter filter;
+        a.expect(!filter.might_contain(style::tag_hash(dom::Atom{"div"})));
+
+        filter.push(div);
+        filter.push(p);
+        a.expect(filter.might_contain(style::tag_hash(dom::Atom{"div"})));
+        a.expect(filter.might_contain(style::tag_hash(dom::Atom{"p"})));
+        a.expect(filter.might_contain(style::id_hash("a")));
+        a.expect(filter.might_contain(style::class_hash("b")));
+        a.expect(filter.might_contain(style::class_hash("c")));
+
+        filter.pop(p);
+        a.expect(!filter.might_contain(style::tag_hash(dom::Atom{"p"})));
+        a.expect(filter.might_contain(style::class_hash("c")));
+
+        filter.pop(div);
+        a.expect(!filter.might_contain(style::tag_hash(dom::Atom{"div"})));
+        a.expect(!filter.might_contain(style::id_hash("a")));
+        a.expect(!filter.might_contain(style::class_hash("b")));
+        a.expect(!filter.might_contain(style::class_hash("c")));
+    });
+
+    s.add_test("tags, ids, and classes are kept apart", [](etest::IActions &a) {
+        AncestorFilter filter;
+        filter.push(dom::Element{"a"});
+        a.expect(filter.might_contain(style::tag_hash(dom::Atom{"a"})));
+        a.expect(!filter.might_contain(style::id_hash("a")));
+        a.expect(!filter.might_contain(style::class_hash("a")));
+    });
+
+    s.add_test("saturated counters", [](etest::IActions &a) {
+        dom::Element div{"div"};
+        AncestorFilter filter;
+        for (int i = 0; i < 300; ++i) {
+            filter.push(div);
+        }
+
+        for (int i = 0; i < 299; ++i) {
+            filter.pop(div);
+        }
+
+        // Rejecting something that's there would be a bug, but a false
+        // positive is fine.
+        a.expect(filter.might_contain(style::tag_hash(dom::Atom{"div"})));
+    });
+
+    s.add_test("might_match", [](etest::IActions &a) {
+        auto selector = Selector::parse("div#a > .b.c p:link").value();
+        a.expect_eq(selector.ancestor_hashes().size(), std::size_t{4});
+        a.expect(Selector::parse("p.a#b").value().ancestor_hashes().empty());
+        a.expect(Selector::parse("* > [href] p").value().ancestor_hashes().empty());
+
+        AncestorFilter filter;
+        dom::Element div{"div", {{"id", "a"}}};
+        dom::Element span{"span", {{"class", "c b"}}};
+
+        filter.push(div);
+        a.expect(!filter.might_match(selector));
+        filter.push(span);
+        a.expect(filter.might_match(selector));
+        filter.pop(span);
+        a.expect(!filter.might_match(selector));
+    });
+
+    return s.run();
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "style/rule_set.h"
+
+#include "style/ancestor_filter.h"
+#include "style/selector.h"
+#include "style/styled_node.h"
+
+#include "css/media_query.h"
+#include "css/rule.h"
+#include "css/style_sheet.h"
+#include "dom/atom.h"
+#include "dom/dom.h"
+#include "util/string.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace style {
+namespace {
+
+template<typename Map, typename Key>
+void add_bucket(Map const &map, Key const &key, auto &candidates) {
+    if (auto it = map.find(key); it != map.end()) {
+        for (auto const &entry : it->second) {
+            candidates.push_back(&entry);
+        }
+    }
+}
+
+} // namespace
+
+RuleSet::RuleSet(css::StyleSheet const &stylesheet, css::MediaQuery::Context const &ctx) {
+    auto bucket_for = [this](CompoundSelector const &subject) -> std::vector<Entry> & {
+        if (!subject.id.empty()) {
+            return ids_[subject.id];
+        }
+
+        if (!subject.classes.empty()) {
+            return classes_[subject.classes.front()];
+        }
+
+        if (!subject.type.empty()) {
+            return tags_[subject.type];
+        }
+
+        return universal_;
+    };
+
+    for (auto const &rule : stylesheet.rules) {
+        if (rule.media_query.has_value() && !rule.media_query->evaluate(ctx)) {
+            continue;
+        }
+
+        auto const index = rules_.size();
+        bool has_selectors = false;
+        for (auto const &selector_text : rule.selectors) {
+            auto selector = Selector::parse(selector_text);
+            if (!selector) {
+                continue;
+            }
+
+            has_selectors = true;
+            for (auto const &compound : selector->compounds()) {
+                for (auto const &attribute : compound.attributes) {
+                    if (std::ranges::find(attribute_names_, attribute.name) == attribute_names_.end()) {
+                        attribute_names_.push_back(attribute.name);
+                    }
+                }
+            }
+
+            bucket_for(selector->compounds().front()).push_back({index, *std::move(selector)});
+        }
+
+        if (has_selectors) {
+            rules_.push_back(&rule);
+        }
+    }
+}
+
+std::vector<css::Rule const *> RuleSet::matching_rules(StyledNode const &node, AncestorFilter const *ancestors) const {
+    auto const &element = std::get<dom::Element>(node.node);
+
+    std::vector<Entry const *> candidates;
+    if (auto id = element.attributes.find(dom::Atom::known("id")); id != element.attributes.end()) {
+        add_bucket(ids_, id->second, candidates);
+    }
+
+    if (auto cls = element.attributes.find(dom::Atom::known("class")); cls != element.attributes.end()) {
+        util::for_each_ascii_whitespace_split(
+                cls->second, [&](std::string_view class_name) { add_bucket(classes_, class_name, candidates); });
+    }
+
+    add_bucket(tags_, element.name, candidates);
+    for (auto const &entry : universal_) {
+        candidates.push_back(&entry);
+    }
+
+    // Every selector is in exactly one bucket, but a bucket can be looked at
+    // more than once if an element has the same class twice, and a rule can
+    // have selectors in several buckets, so the rules are deduplicated here.
+    std::ranges::sort(candidates, {}, &Entry::rule);
+    std::vector<css::Rule const *> matching;
+    std::size_t last_matched = rules_.size();
+    for (auto const *candidate : candidates) {
+        if (candidate->rule == last_matched) {
+            continue;
+        }
+
+        if (ancestors != nullptr && !ancestors->might_match(candidate->selector)) {
+            continue;
+        }
+
+        if (candidate->selector.is_match(node)) {
+            matching.push_back(rules_[candidate->rule]);
+            last_matched = candidate->rule;
+        }
+    }
+
+    return matching;
+}
+
+} // namespace style
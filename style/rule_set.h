@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef STYLE_RULE_SET_H_
+#define STYLE_RULE_SET_H_
+
+#include "style/ancestor_filter.h"
+#include "style/selector.h"
+#include "style/styled_node.h"
+
+#include "css/media_query.h"
+#include "css/rule.h"
+#include "css/style_sheet.h"
+#include "dom/atom.h"
+#include "util/string.h"
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace style {
+
+// The rules of a stylesheet that apply in a media context, with their
+// selectors parsed and put into buckets based on what the element itself needs
+// to have for them to match: an id, a class, or a tag name, in that order of
+// preference. Finding the rules matching an element then only requires
+// checking the selectors in the buckets it could be in rather than every rule
+// in the stylesheet.
+//
+// The set refers to the stylesheet's rules, so it must not outlive it.
+class RuleSet {
+public:
+    RuleSet(css::StyleSheet const &, css::MediaQuery::Context const &);
+
+    // The rules matching the element, in the order they're in in the stylesheet.
+    //
+    // If a filter of the element's ancestors is passed, selectors it shows
+    // can't match are rejected without walking up the tree.
+    [[nodiscard]] std::vector<css::Rule const *> matching_rules(
+            StyledNode const &, AncestorFilter const *ancestors = nullptr) const;
+
+    // The number of rules that apply in the media context.
+    [[nodiscard]] std::size_t size() const { return rules_.size(); }
+
+    // The attributes that any selector in the set checks the presence or value
+    // of, not counting ids and classes.
+    [[nodiscard]] std::span<dom::Atom const> attribute_names() const { return attribute_names_; }
+
+private:
+    struct Entry {
+        std::size_t rule{};
+        Selector selector;
+    };
+
+    template<typename T>
+    using StringMap = std::unordered_map<std::string, T, util::TransparentStringHash, std::equal_to<>>;
+
+    std::vector<css::Rule const *> rules_;
+    StringMap<std::vector<Entry>> ids_;
+    StringMap<std::vector<Entry>> classes_;
+    std::unordered_map<dom::Atom, std::vector<Entry>> tags_;
+    std::vector<Entry> universal_;
+    std::vector<dom::Atom> attribute_names_;
+};
+
+} // namespace style
+
+#endif
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "style/rule_set.h"
+
+#include "style/ancestor_filter.h"
+#include "style/styled_node.h"
+
+#include "css/media_query.h"
+#include "css/rule.h"
+#include "css/style_sheet.h"
+#include "dom/dom.h"
+#include "etest/etest2.h"
+
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+using style::RuleSet;
+
+int main() {
+    etest::Suite s{"RuleSet"};
+
+    s.add_test("buckets", [](etest::IActions &a) {
+        css::StyleSheet stylesheet{{
+                css::Rule{.selectors{"#a"}},
+                css::Rule{.selectors{".b"}},
+                css::Rule{.selectors{"p"}},
+                css::Rule{.selectors{"*"}},
+                css::Rule{.selectors{"span.b"}},
+                css::Rule{.selectors{"#c"}},
+                css::Rule{.selectors{".d"}},
+                css::Rule{.selectors{"div"}},
+        }};
+        RuleSet rules{stylesheet, {}};
+        a.expect_eq(rules.size(), std::size_t{8});
+
+        dom::Node dom = dom::Element{"p", {{"id", "a"}, {"class", "x b"}}};
+        style::StyledNode node{dom};
+        a.expect(rules.matching_rules(node)
+                == std::vector<css::Rule const *>{
+                        &stylesheet.rules[0], &stylesheet.rules[1], &stylesheet.rules[2], &stylesheet.rules[3]});
+
+        dom::Node span_dom = dom::Element{"span", {{"class", "d\tb"}}};
+        style::StyledNode span{span_dom};
+        a.expect(rules.matching_rules(span)
+                == std::vector<css::Rule const *>{
+                        &stylesheet.rules[1], &stylesheet.rules[3], &stylesheet.rules[4], &stylesheet.rules[6]});
+    });
+
+    s.add_test("rules are only matched once", [](etest::IActions &a) {
+        css::StyleSheet stylesheet{{
+                css::Rule{.selectors{".a", "p", "*", "#b"}},
+                css::Rule{.selectors{".a"}},
+        }};
+        RuleSet rules{stylesheet, {}};
+
+        dom::Node dom = dom::Element{"p", {{"id", "b"}, {"class", "a a"}}};
+        style::StyledNode node{dom};
+        a.expect(rules.matching_rules(node)
+                == std::vector<css::Rule const *>{&stylesheet.rules[0], &stylesheet.rules[1]});
+    });
+
+    s.add_test("combinators", [](etest::IActions &a) {
+        css::StyleSheet stylesheet{{
+                css::Rule{.selectors{"div > p"}},
+                css::Rule{.selectors{"span p"}},
+                css::Rule{.selectors{".a p"}},
+        }};
+        RuleSet rules{stylesheet, {}};
+
+        dom::Node div = dom::Element{"div", {{"class", "a"}}};
+        dom::Node p = dom::Element{"p"};
+        style::StyledNode root{div, {}, {{p}}};
+        root.children[0].parent = &root;
+        a.expect(rules.matching_rules(root).empty());
+        a.expect(rules.matching_rules(root.children[0])
+                == std::vector<css::Rule const *>{&stylesheet.rules[0], &stylesheet.rules[2]});
+
+        // Selectors are rejected based on the filter alone, so one that
+        // doesn't contain the ancestors means nothing with combinators matches.
+        style::AncestorFilter ancestors;
+        a.expect(rules.matching_rules(root.children[0], &ancestors).empty());
+
+        ancestors.push(std::get<dom::Element>(div));
+        a.expect(rules.matching_rules(root.children[0], &ancestors)
+                == std::vector<css::Rule const *>{&stylesheet.rules[0], &stylesheet.rules[2]});
+    });
+
+    s.add_test("unsupported selectors and media queries", [](etest::IActions &a) {
+        css::StyleSheet stylesheet{{
+                css::Rule{.selectors{"p"}, .media_query{css::MediaQuery::parse("(min-width: 700px)")}},
+                css::Rule{.selectors{"p:hover"}},
+                css::Rule{.selectors{"p:hover", "p"}},
+        }};
+
+        RuleSet narrow{stylesheet, {.window_width = 600}};
+        a.expect_eq(narrow.size(), std::size_t{1});
+
+        RuleSet wide{stylesheet, {.window_width = 800}};
+        a.expect_eq(wide.size(), std::size_t{2});
+
+        dom::Node dom = dom::Element{"p"};
+        style::StyledNode node{dom};
+        a.expect(narrow.matching_rules(node) == std::vector<css::Rule const *>{&stylesheet.rules[2]});
+        a.expect(wide.matching_rules(node)
+                == std::vector<css::Rule const *>{&stylesheet.rules[0], &stylesheet.rules[2]});
+    });
+
+    s.add_test("attribute_names", [](etest::IActions &a) {
+        css::StyleSheet stylesheet{{
+                css::Rule{.selectors{"a[href]", "[title=hi] p"}},
+                css::Rule{.selectors{"p[href='/']:link", "#a.b"}},
+        }};
+        RuleSet rules{stylesheet, {}};
+
+        a.require(rules.attribute_names().size() == 2);
+        a.expect_eq(rules.attribute_names()[0].str(), "href");
+        a.expect_eq(rules.attribute_names()[1].str(), "title");
+    });
+
+    return s.run();
+}
@@ -0,0 +1,285 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "style/selector.h"
+
+#include "style/ancestor_filter.h"
+#include "style/styled_node.h"
+
+#include "dom/atom.h"
+#include "dom/dom.h"
+#include "util/string.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace style {
+namespace {
+
+bool contains_class(std::string_view classes, std::string_view needle_class) {
+    bool found = false;
+    util::for_each_ascii_whitespace_split(classes, [&](std::string_view cls) { found = found || cls == needle_class; });
+    return found;
+}
+
+// Consumes everything up until the next part of the selector.
+std::string_view consume_name(std::string_view &selector) {
+    auto end = std::min(selector.find_first_of(" \t\n\f\r.#[:>+~,()*"), selector.size());
+    auto name = selector.substr(0, end);
+    selector.remove_prefix(end);
+    return name;
+}
+
+// https://developer.mozilla.org/en-US/docs/Web/CSS/Attribute_selectors
+std::optional<AttributeSelector> parse_attribute(std::string_view attr) {
+    auto [name, value] = util::split_once(attr, '=');
+    name = util::trim(name);
+    // [a~=b] and friends aren't supported.
+    if (name.empty() || name.find_first_of("~|^$*") != std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    if (!attr.contains('=')) {
+        return AttributeSelector{.name = name};
+    }
+
+    value = util::trim(value);
+    if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+        value = value.substr(1, value.size() - 2);
+    }
+
+    return AttributeSelector{.name = name, .value = std::string{value}};
+}
+
+std::optional<CompoundSelector> parse_compound(std::string_view &selector, Specificity &specificity) {
+    CompoundSelector compound;
+    bool is_empty = true;
+
+    // https://developer.mozilla.org/en-US/docs/Web/CSS/Universal_selectors
+    if (selector.starts_with('*')) {
+        selector.remove_prefix(1);
+        is_empty = false;
+    } else if (auto type = consume_name(selector); !type.empty()) {
+        compound.type = dom::Atom{type};
+        specificity.types += 1;
+        is_empty = false;
+    }
+
+    while (!selector.empty()) {
+        auto const kind = selector.front();
+        if (kind == '.') {
+            selector.remove_prefix(1);
+            auto name = consume_name(selector);
+            if (name.empty()) {
+                return std::nullopt;
+            }
+
+            compound.classes.emplace_back(name);
+            specificity.classes += 1;
+        } else if (kind == '#') {
+            selector.remove_prefix(1);
+            auto id = consume_name(selector);
+            // An element only has one id, so #a#b can never match.
+            if (id.empty() || (!compound.id.empty() && compound.id != id)) {
+                return std::nullopt;
+            }
+
+            compound.id = id;
+            specificity.ids += 1;
+        } else if (kind == '[') {
+            auto end = selector.find(']');
+            if (end == std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            auto attribute = parse_attribute(selector.substr(1, end - 1));
+            if (!attribute) {
+                return std::nullopt;
+            }
+
+            selector.remove_prefix(end + 1);
+            compound.attributes.push_back(*std::move(attribute));
+            specificity.classes += 1;
+        } else if (kind == ':') {
+            // https://developer.mozilla.org/en-US/docs/Web/CSS/Pseudo-classes
+            selector.remove_prefix(1);
+            auto pseudo_class = consume_name(selector);
+            if (pseudo_class == "link" || pseudo_class == "any-link") {
+                compound.pseudo_classes |= CompoundSelector::kLink;
+            } else if (pseudo_class == "root") {
+                compound.pseudo_classes |= CompoundSelector::kRoot;
+            } else {
+                // Unhandled pseudo-classes never match.
+                return std::nullopt;
+            }
+
+            specificity.classes += 1;
+        } else {
+            break;
+        }
+
+        is_empty = false;
+    }
+
+    if (is_empty) {
+        return std::nullopt;
+    }
+
+    return compound;
+}
+
+} // namespace
+
+bool CompoundSelector::is_match(StyledNode const &node) const {
+    auto const &element = std::get<dom::Element>(node.node);
+    if (!type.empty() && element.name != type) {
+        return false;
+    }
+
+    if (!id.empty()) {
+        auto it = element.attributes.find(dom::Atom::known("id"));
+        if (it == element.attributes.end() || it->second != id) {
+            return false;
+        }
+    }
+
+    if (!classes.empty()) {
+        auto it = element.attributes.find(dom::Atom::known("class"));
+        if (it == element.attributes.end()) {
+            return false;
+        }
+
+        auto const &class_attr = it->second;
+        if (!std::ranges::all_of(classes, [&](auto const &cls) { return contains_class(class_attr, cls); })) {
+            return false;
+        }
+    }
+
+    for (auto const &attribute : attributes) {
+        auto it = element.attributes.find(attribute.name);
+        if (it == element.attributes.end() || (attribute.value.has_value() && it->second != *attribute.value)) {
+            return false;
+        }
+    }
+
+    if ((pseudo_classes & kLink) != 0) {
+        if (!element.attributes.contains(dom::Atom::known("href"))) {
+            return false;
+        }
+
+        if (element.name != dom::Atom::known("a") && element.name != dom::Atom::known("area")) {
+            return false;
+        }
+    }
+
+    if ((pseudo_classes & kRoot) != 0 && node.parent != nullptr) {
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<Selector> Selector::parse(std::string_view selector) {
+    Selector result;
+    selector = util::trim(selector);
+
+    while (true) {
+        auto compound = parse_compound(selector, result.specificity_);
+        if (!compound) {
+            return std::nullopt;
+        }
+
+        result.compounds_.push_back(*std::move(compound));
+
+        auto const before_whitespace = selector.size();
+        selector = util::trim_start(selector);
+        if (selector.empty()) {
+            break;
+        }
+
+        // https://developer.mozilla.org/en-US/docs/Web/CSS/Child_combinator
+        // https://developer.mozilla.org/en-US/docs/Web/CSS/Descendant_combinator
+        if (selector.starts_with('>')) {
+            selector = util::trim_start(selector.substr(1));
+            result.combinators_.push_back(Combinator::Child);
+        } else if (selector.size() != before_whitespace) {
+            result.combinators_.push_back(Combinator::Descendant);
+        } else {
+            // Sibling combinators, selector lists, and anything else we don't
+            // understand.
+            return std::nullopt;
+        }
+    }
+
+    // Matching starts with the element itself and moves up the tree.
+    std::ranges::reverse(result.compounds_);
+    std::ranges::reverse(result.combinators_);
+
+    for (auto const &compound : std::span{result.compounds_}.subspan(1)) {
+        if (!compound.type.empty()) {
+            result.ancestor_hashes_.push_back(tag_hash(compound.type));
+        }
+
+        if (!compound.id.empty()) {
+            result.ancestor_hashes_.push_back(id_hash(compound.id));
+        }
+
+        for (auto const &cls : compound.classes) {
+            result.ancestor_hashes_.push_back(class_hash(cls));
+        }
+    }
+
+    return result;
+}
+
+// What to do when the remaining compounds fail to match, so that selectors like
+// "p div div div" don't have to try every possible combination of ancestors
+// before failing. This is the approach used by Servo and other engines.
+enum class Selector::MatchResult : std::uint8_t {
+    Matched,
+    // Trying higher up ancestors for the closest descendant combinator may
+    // still lead to a match.
+    RetryFromClosestDescendant,
+    // We ran out of ancestors, so trying higher up ones won't help.
+    NotMatchedGlobally,
+};
+
+// NOLINTNEXTLINE(misc-no-recursion)
+Selector::MatchResult Selector::match_ancestors(StyledNode const &node, std::size_t compound) const {
+    if (compound + 1 == compounds_.size()) {
+        return MatchResult::Matched;
+    }
+
+    auto const combinator = combinators_[compound];
+    auto const &next = compounds_[compound + 1];
+    for (auto const *ancestor = node.parent; ancestor != nullptr; ancestor = ancestor->parent) {
+        if (next.is_match(*ancestor)) {
+            auto result = match_ancestors(*ancestor, compound + 1);
+            if (result != MatchResult::RetryFromClosestDescendant) {
+                return result;
+            }
+        }
+
+        if (combinator == Combinator::Child) {
+            return MatchResult::RetryFromClosestDescendant;
+        }
+    }
+
+    return MatchResult::NotMatchedGlobally;
+}
+
+bool Selector::is_match(StyledNode const &node) const {
+    return compounds_.front().is_match(node) && match_ancestors(node, 0) == MatchResult::Matched;
+}
+
+} // namespace style
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef STYLE_SELECTOR_H_
+#define STYLE_SELECTOR_H_
+
+#include "style/styled_node.h"
+
+#include "dom/atom.h"
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace style {
+
+// https://www.w3.org/TR/selectors-4/#specificity-rules
+struct Specificity {
+    std::uint16_t ids{};
+    std::uint16_t classes{};
+    std::uint16_t types{};
+    [[nodiscard]] std::strong_ordering operator<=>(Specificity const &) const = default;
+};
+
+// https://developer.mozilla.org/en-US/docs/Web/CSS/Attribute_selectors
+struct AttributeSelector {
+    dom::Atom name;
+    // Only the presence of the attribute is checked if this is empty.
+    std::optional<std::string> value;
+    [[nodiscard]] bool operator==(AttributeSelector const &) const = default;
+};
+
+// https://www.w3.org/TR/selectors-4/#compound
+struct CompoundSelector {
+    // https://developer.mozilla.org/en-US/docs/Web/CSS/:any-link
+    // https://developer.mozilla.org/en-US/docs/Web/CSS/:link
+    // https://developer.mozilla.org/en-US/docs/Web/CSS/:visited
+    // Ignoring :visited for now as we treat all links as unvisited.
+    static constexpr std::uint8_t kLink = 1U << 0;
+    // https://developer.mozilla.org/en-US/docs/Web/CSS/:root
+    static constexpr std::uint8_t kRoot = 1U << 1;
+
+    // Any element matches if this is empty.
+    dom::Atom type;
+    std::string id;
+    std::vector<std::string> classes;
+    std::vector<AttributeSelector> attributes;
+    std::uint8_t pseudo_classes{};
+
+    [[nodiscard]] bool is_match(StyledNode const &) const;
+    [[nodiscard]] bool operator==(CompoundSelector const &) const = default;
+};
+
+// https://www.w3.org/TR/selectors-4/#combinators
+enum class Combinator : std::uint8_t {
+    Descendant,
+    Child,
+};
+
+// https://www.w3.org/TR/selectors-4/#complex
+//
+// Parsed once up front so that matching it against an element doesn't involve
+// any string processing beyond comparing class names and attribute values.
+class Selector {
+public:
+    // Returns nothing for selectors we don't support, as those never match.
+    [[nodiscard]] static std::optional<Selector> parse(std::string_view);
+
+    [[nodiscard]] bool is_match(StyledNode const &) const;
+
+    // The compound selectors, starting with the one the element itself has to
+    // match, and then moving towards the root.
+    [[nodiscard]] std::span<CompoundSelector const> compounds() const { return compounds_; }
+    // The combinator between compounds()[i] and compounds()[i + 1].
+    [[nodiscard]] std::span<Combinator const> combinators() const { return combinators_; }
+    [[nodiscard]] Specificity specificity() const { return specificity_; }
+    // Hashes of the tags, ids, and classes that must be present among the
+    // ancestors of a matching element. See AncestorFilter.
+    [[nodiscard]] std::span<std::uint32_t const> ancestor_hashes() const { return ancestor_hashes_; }
+
+    [[nodiscard]] bool operator==(Selector const &) const = default;
+
+private:
+    Selector() = default;
+
+    enum class MatchResult : std::uint8_t;
+    MatchResult match_ancestors(StyledNode const &, std::size_t compound) const;
+
+    std::vector<CompoundSelector> compounds_;
+    std::vector<Combinator> combinators_;
+    Specificity specificity_;
+    std::vector<std::uint32_t> ancestor_hashes_;
+};
+
+} // namespace style
+
+#endif
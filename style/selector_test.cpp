@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "style/selector.h"
+
+#include "style/styled_node.h"
+
+#include "dom/dom.h"
+#include "etest/etest2.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using style::Combinator;
+using style::CompoundSelector;
+using style::Selector;
+using style::Specificity;
+
+namespace {
+void set_up_parent_ptrs(style::StyledNode &root) {
+    std::vector<style::StyledNode *> stack{&root};
+    while (!stack.empty()) {
+        auto *current = stack.back();
+        stack.pop_back();
+
+        for (auto &child : current->children) {
+            child.parent = current;
+            stack.push_back(&child);
+        }
+    }
+}
+} // namespace
+
+int main() {
+    etest::Suite s{"Selector"};
+
+    s.add_test("parse, compound", [](etest::IActions &a) {
+        auto selector = Selector::parse("  a#hi.b.c[href][rel=\"icon\"]:link  ");
+        a.require(selector.has_value());
+        a.require(selector->compounds().size() == 1);
+        a.expect(selector->combinators().empty());
+
+        auto const &compound = selector->compounds()[0];
+        a.expect_eq(compound.type.str(), "a");
+        a.expect_eq(compound.id, "hi");
+        a.expect_eq(compound.classes, std::vector<std::string>{"b", "c"});
+        a.require(compound.attributes.size() == 2);
+        a.expect_eq(compound.attributes[0].name.str(), "href");
+        a.expect(!compound.attributes[0].value.has_value());
+        a.expect_eq(compound.attributes[1].name.str(), "rel");
+        a.expect(compound.attributes[1].value == "icon");
+        a.expect(compound.pseudo_classes == CompoundSelector::kLink);
+        a.expect(selector->specificity() == Specificity{1, 5, 1});
+    });
+
+    s.add_test("parse, combinators", [](etest::IActions &a) {
+        auto selector = Selector::parse("div>p  .a > *");
+        a.require(selector.has_value());
+        a.require(selector->compounds().size() == 4);
+
+        // The compounds are stored starting with the element being matched.
+        a.expect(selector->compounds()[0].type.empty());
+        a.expect_eq(selector->compounds()[1].classes, std::vector<std::string>{"a"});
+        a.expect_eq(selector->compounds()[2].type.str(), "p");
+        a.expect_eq(selector->compounds()[3].type.str(), "div");
+        a.expect(selector->combinators()[0] == Combinator::Child);
+        a.expect(selector->combinators()[1] == Combinator::Descendant);
+        a.expect(selector->combinators()[2] == Combinator::Child);
+        a.expect(selector->specificity() == Specificity{0, 1, 2});
+    });
+
+    s.add_test("parse, unsupported", [](etest::IActions &a) {
+        a.expect(!Selector::parse("").has_value());
+        a.expect(!Selector::parse("a + b").has_value());
+        a.expect(!Selector::parse("a ~ b").has_value());
+        a.expect(!Selector::parse("a >").has_value());
+        a.expect(!Selector::parse("> a").has_value());
+        a.expect(!Selector::parse("a:hover").has_value());
+        a.expect(!Selector::parse("a::before").has_value());
+        a.expect(!Selector::parse("[a").has_value());
+        a.expect(!Selector::parse("[a^=b]").has_value());
+        a.expect(!Selector::parse("a.").has_value());
+        a.expect(!Selector::parse("#a#b").has_value());
+        a.expect(Selector::parse("#a#a").has_value());
+    });
+
+    s.add_test("is_match", [](etest::IActions &a) {
+        dom::Node dom = dom::Element{"a", {{"href", "/"}, {"class", "x\ty"}, {"id", "i"}, {"rel", "icon"}}};
+        style::StyledNode node{dom};
+
+        auto is_match = [&](std::string_view selector) {
+            return Selector::parse(selector).value().is_match(node);
+        };
+
+        a.expect(is_match("*"));
+        a.expect(is_match("*.x"));
+        a.expect(is_match("a.y.x"));
+        a.expect(is_match("a#i"));
+        a.expect(is_match("#i.x[rel=icon]"));
+        a.expect(is_match("[rel='icon']"));
+        a.expect(is_match(":root:link"));
+        a.expect(!is_match("a.z"));
+        a.expect(!is_match("b#i"));
+        a.expect(!is_match("[rel=con]"));
+        a.expect(!is_match("a[title]"));
+    });
+
+    s.add_test("is_match, mixed combinators", [](etest::IActions &a) {
+        // div.a > div > div.b > p
+        dom::Node dom = dom::Element{"div", {{"class", "a"}}};
+        dom::Node inner_dom = dom::Element{"div"};
+        dom::Node b_dom = dom::Element{"div", {{"class", "b"}}};
+        dom::Node p_dom = dom::Element{"p"};
+        style::StyledNode root{dom, {}, {{inner_dom, {}, {{b_dom, {}, {{p_dom}}}}}}};
+        set_up_parent_ptrs(root);
+        auto const &p = root.children[0].children[0].children[0];
+
+        auto is_match = [&](std::string_view selector) {
+            return Selector::parse(selector).value().is_match(p);
+        };
+
+        // The closest div isn't a child of .a, but one higher up is.
+        a.expect(is_match(".a > div p"));
+        a.expect(is_match(".a div > .b > p"));
+        a.expect(is_match(".a > div div > p"));
+        a.expect(is_match("div > div > div > p"));
+        a.expect(!is_match("div > div > div > div > p"));
+        a.expect(!is_match(".a > div > p"));
+        a.expect(!is_match(".b > div p"));
+        a.expect(!is_match("span div p"));
+    });
+
+    s.add_test("is_match, deep trees", [](etest::IActions &a) {
+        dom::Node dom = dom::Element{"div"};
+        style::StyledNode root{dom};
+        auto *current = &root;
+        for (int i = 0; i < 64; ++i) {
+            current = &current->children.emplace_back(dom);
+        }
+        set_up_parent_ptrs(root);
+
+        // Would take forever if every combination of ancestors was tried
+        // before giving up.
+        std::string selector = "p";
+        for (int i = 0; i < 32; ++i) {
+            selector += " div";
+        }
+
+        a.expect(!Selector::parse(selector).value().is_match(*current));
+        a.expect(Selector::parse(selector.substr(2)).value().is_match(*current));
+    });
+
+    return s.run();
+}
@@ -4,23 +4,32 @@
 
 #include "style/style.h"
 
+#include "style/ancestor_filter.h"
+#include "style/rule_set.h"
+#include "style/selector.h"
 #include "style/styled_node.h"
 
 #include "css/media_query.h"
 #include "css/parser.h"
 #include "css/property_id.h"
 #include "css/style_sheet.h"
+#include "dom/atom.h"
 #include "dom/dom.h"
-#include "util/string.h"
 
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
 #include <iterator>
 #include <memory>
-#include <ranges>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -29,236 +38,316 @@ using namespace std::literals;
 
 namespace style {
 namespace {
-bool contains_class(std::string_view classes, std::string_view needle_class) {
-    for (auto cls : classes | std::views::split(' ')) {
-        if (std::string_view{cls} == needle_class) {
-            return true;
-        }
-    }
 
-    return false;
-}
-} // namespace
+MatchingProperties matching_properties(
+        StyledNode const &node, RuleSet const &rules, AncestorFilter const *ancestors = nullptr) {
+    std::vector<std::pair<css::PropertyId, std::string>> matched_properties;
+    std::vector<std::pair<std::string, std::string>> matched_custom_properties;
 
-// TODO(robinlinden): This needs to match more things.
-// NOLINTNEXTLINE(misc-no-recursion)
-bool is_match(style::StyledNode const &node, std::string_view selector) {
-    auto const &element = std::get<dom::Element>(node.node);
-    // https://developer.mozilla.org/en-US/docs/Web/CSS/Pseudo-classes
-    auto [selector_, psuedo_class] = util::split_once(selector, ':');
-
-    // https://developer.mozilla.org/en-US/docs/Web/CSS/Child_combinator
-    if (selector_.contains('>')) {
-        // TODO(robinlinden): std::views::reverse and friends when we drop Clang 14 and 15.
-        auto parts = util::split(selector_, ">");
-        selector_ = util::trim(parts.back());
-        parts.pop_back();
-        std::ranges::reverse(parts);
-
-        // We only check the parent and up here, and if they all match, we fall
-        // through and check this node.
-        auto const *current = node.parent;
-        for (auto part : parts) {
-            part = util::trim(part);
-            // TODO(robinlinden): Handle descendant and child combinators in the same selector.
-            if (part.contains(' ')) {
-                return false;
-            }
+    auto const matching_rules = rules.matching_rules(node, ancestors);
+    for (auto const *rule : matching_rules) {
+        std::ranges::copy(rule->declarations, std::back_inserter(matched_properties));
+        std::ranges::copy(rule->custom_properties, std::back_inserter(matched_custom_properties));
+    }
 
-            if (current == nullptr || !is_match(*current, part)) {
-                return false;
+    if (auto const *element = std::get_if<dom::Element>(&node.node)) {
+        auto style_attr = element->attributes.find(dom::Atom::known("style"));
+        if (style_attr != element->attributes.end()) {
+            // TODO(robinlinden): Incredibly hacky, but our //css parser doesn't support
+            // parsing only declarations. Replace with the //css2 parser once possible.
+            auto element_style = css::parse("dummy{"s + style_attr->second + "}"s).rules;
+            // The above should always parse to 1 rule when using the old parser.
+            if (element_style.size() == 1) {
+                std::ranges::copy(element_style[0].declarations, std::back_inserter(matched_properties));
+                std::ranges::copy(element_style[0].important_declarations, std::back_inserter(matched_properties));
+                std::ranges::copy(element_style[0].custom_properties, std::back_inserter(matched_custom_properties));
+            } else {
+                spdlog::warn("Failed to parse inline style '{}' for element '{}'",
+                        style_attr->second,
+                        element->name.str());
             }
-
-            current = current->parent;
         }
     }
 
-    // https://developer.mozilla.org/en-US/docs/Web/CSS/Descendant_combinator
-    if (selector_.contains(' ')) {
-        // TODO(robinlinden): std::views::reverse and friends when we drop Clang 14 and 15.
-        auto parts = util::split(selector_, " ");
-        selector_ = util::trim(parts.back());
-        parts.pop_back();
-        std::ranges::reverse(parts);
-
-        // We only check the parent and up here, and if they all match, we fall
-        // through and check this node.
-        auto const *current = node.parent;
-        for (auto const &part : parts) {
-            while (current != nullptr && !is_match(*current, util::trim(part))) {
-                current = current->parent;
-            }
-
-            if (current == nullptr) {
-                return false;
-            }
-
-            current = current->parent;
-        }
+    // TODO(robinlinden): !important inline styles should override the ones from
+    // the style sheets.
+    for (auto const *rule : matching_rules) {
+        std::ranges::copy(rule->important_declarations, std::back_inserter(matched_properties));
     }
 
-    if (!psuedo_class.empty()) {
-        if (psuedo_class == "link" || psuedo_class == "any-link") {
-            // https://developer.mozilla.org/en-US/docs/Web/CSS/:any-link
-            // https://developer.mozilla.org/en-US/docs/Web/CSS/:link
-            // https://developer.mozilla.org/en-US/docs/Web/CSS/:visited
-            // Ignoring :visited for now as we treat all links as unvisited.
-            if (!element.attributes.contains("href")) {
-                return false;
-            }
+    return {std::move(matched_properties), std::move(matched_custom_properties)};
+}
 
-            if (element.name != "a" && element.name != "area") {
-                return false;
-            }
+} // namespace
 
-            if (selector_.empty()) {
-                return true;
-            }
-        } else if (psuedo_class == "root") {
-            // https://developer.mozilla.org/en-US/docs/Web/CSS/:root
-            if (node.parent != nullptr) {
-                return false;
-            }
+bool is_match(style::StyledNode const &node, std::string_view selector) {
+    auto parsed = Selector::parse(selector);
+    return parsed.has_value() && parsed->is_match(node);
+}
 
-            if (selector_.empty()) {
-                return true;
-            }
-        } else {
-            // Unhandled psuedo-classes never match.
-            return false;
-        }
-    }
+MatchingProperties matching_properties(
+        style::StyledNode const &node, css::StyleSheet const &stylesheet, css::MediaQuery::Context const &ctx) {
+    return matching_properties(node, RuleSet{stylesheet, ctx});
+}
 
-    // https://developer.mozilla.org/en-US/docs/Web/CSS/Universal_selectors
-    if (selector_ == "*") {
-        return true;
+namespace {
+std::optional<std::string_view> find_attribute(dom::Element const &element, dom::Atom name) {
+    auto it = element.attributes.find(name);
+    if (it == element.attributes.end()) {
+        return std::nullopt;
     }
 
-    if (element.name == selector_) {
-        return true;
-    }
+    return it->second;
+}
 
-    auto class_position = selector_.find('.');
-    if (class_position != std::string_view::npos) {
-        auto class_attr = element.attributes.find("class");
-        if (class_attr == element.attributes.end()) {
+// Elements that are equivalent as far as selector matching goes can share the
+// properties matched for one of them instead of matching every rule again,
+// which makes e.g. long lists of identical <li>s a lot cheaper to style.
+//
+// Two elements are equivalent if they have the same tag, the same classes, and
+// the same values for any attributes selectors look at, neither has an id or
+// an inline style, and they either have the same parent or parents that are
+// equivalent themselves. Any selector matching one of them then has to match
+// the other one as well.
+class StyleSharingCache {
+public:
+    explicit StyleSharingCache(RuleSet const &rules) : rules_{rules} {}
+
+    // Shares the properties of a recently styled element equivalent to this
+    // one, if there is one.
+    bool try_share(StyledNode &node) {
+        auto const &element = std::get<dom::Element>(node.node);
+        if (!is_shareable(element)) {
             return false;
         }
 
-        auto class_string = selector_.substr(class_position);
-        if (class_position != 0 && selector_.substr(0, class_position) != element.name) {
-            return false;
-        }
+        auto const *parent = representative(node.parent);
+        auto it = std::ranges::find_if(candidates_, [&](Candidate const &candidate) {
+            return candidate.parent == parent
+                    && is_equivalent(std::get<dom::Element>(candidate.node->node), element);
+        });
 
-        class_string.remove_prefix(1);
-        for (auto cls : class_string | std::views::split('.')) {
-            if (!contains_class(class_attr->second, std::string_view{cls})) {
-                return false;
-            }
+        if (it == candidates_.end()) {
+            return false;
         }
 
+        node.properties = it->node->properties;
+        node.custom_properties = it->node->custom_properties;
+        representatives_[&node] = representative(it->node);
         return true;
     }
 
-    if (selector_.starts_with('#')) {
-        auto it = element.attributes.find("id");
-        selector_.remove_prefix(1);
-        return it != element.attributes.end() && it->second == selector_;
-    }
-
-    // https://developer.mozilla.org/en-US/docs/Web/CSS/Attribute_selectors
-    if (selector_.starts_with('[') && selector_.contains(']')) {
-        selector_.remove_prefix(1);
-        auto [attr, rest] = util::split_once(selector_, ']');
-        if (!rest.empty() && !is_match(node, rest)) {
-            return false;
+    // Makes the element available for sharing with elements styled after it.
+    void insert(StyledNode const &node) {
+        if (!is_shareable(std::get<dom::Element>(node.node))) {
+            return;
         }
 
-        auto [key, value] = util::split_once(attr, '=');
-        if (value.empty()) {
-            return element.attributes.contains(key);
+        if (candidates_.size() == kMaxCandidates) {
+            candidates_.pop_back();
         }
 
-        auto it = element.attributes.find(key);
-        return it != element.attributes.end() && it->second == value;
+        candidates_.insert(candidates_.begin(), {&node, representative(node.parent)});
     }
 
-    return false;
-}
+private:
+    // Enough to cover repeated siblings and cousins a few levels apart while
+    // keeping lookups cheap. Servo uses a similar number.
+    static constexpr std::size_t kMaxCandidates = 16;
 
-MatchingProperties matching_properties(
-        style::StyledNode const &node, css::StyleSheet const &stylesheet, css::MediaQuery::Context const &ctx) {
-    std::vector<std::pair<css::PropertyId, std::string>> matched_properties;
-    std::vector<std::pair<std::string, std::string>> matched_custom_properties;
+    struct Candidate {
+        StyledNode const *node{};
+        StyledNode const *parent{};
+    };
+
+    static bool is_shareable(dom::Element const &element) {
+        return !element.attributes.contains(dom::Atom::known("id"))
+                && !element.attributes.contains(dom::Atom::known("style"));
+    }
 
-    for (auto const &rule : stylesheet.rules) {
-        if (rule.media_query.has_value() && !rule.media_query->evaluate(ctx)) {
-            continue;
+    bool is_equivalent(dom::Element const &a, dom::Element const &b) const {
+        if (a.name != b.name) {
+            return false;
         }
 
-        if (std::ranges::any_of(rule.selectors, [&](auto const &selector) { return is_match(node, selector); })) {
-            std::ranges::copy(rule.declarations, std::back_inserter(matched_properties));
-            std::ranges::copy(rule.custom_properties, std::back_inserter(matched_custom_properties));
+        if (find_attribute(a, dom::Atom::known("class")) != find_attribute(b, dom::Atom::known("class"))) {
+            return false;
         }
-    }
 
-    if (auto const *element = std::get_if<dom::Element>(&node.node)) {
-        auto style_attr = element->attributes.find("style");
-        if (style_attr != element->attributes.end()) {
-            // TODO(robinlinden): Incredibly hacky, but our //css parser doesn't support
-            // parsing only declarations. Replace with the //css2 parser once possible.
-            auto element_style = css::parse("dummy{"s + style_attr->second + "}"s).rules;
-            // The above should always parse to 1 rule when using the old parser.
-            if (element_style.size() == 1) {
-                std::ranges::copy(element_style[0].declarations, std::back_inserter(matched_properties));
-                std::ranges::copy(element_style[0].important_declarations, std::back_inserter(matched_properties));
-                std::ranges::copy(element_style[0].custom_properties, std::back_inserter(matched_custom_properties));
-            } else {
-                spdlog::warn("Failed to parse inline style '{}' for element '{}'", style_attr->second, element->name);
-            }
+        // :link
+        if (a.attributes.contains(dom::Atom::known("href")) != b.attributes.contains(dom::Atom::known("href"))) {
+            return false;
         }
+
+        return std::ranges::all_of(rules_.attribute_names(),
+                [&](dom::Atom name) { return find_attribute(a, name) == find_attribute(b, name); });
     }
 
-    // TODO(robinlinden): !important inline styles should override the ones from
-    // the style sheets.
-    for (auto const &rule : stylesheet.rules) {
-        if (rule.important_declarations.empty() || (rule.media_query.has_value() && !rule.media_query->evaluate(ctx))) {
-            continue;
-        }
+    // The element that was styled first out of the ones equivalent to this one.
+    StyledNode const *representative(StyledNode const *node) const {
+        auto it = representatives_.find(node);
+        return it == representatives_.end() ? node : it->second;
+    }
 
-        if (std::ranges::any_of(rule.selectors, [&](auto const &selector) { return is_match(node, selector); })) {
-            std::ranges::copy(rule.important_declarations, std::back_inserter(matched_properties));
-        }
+    RuleSet const &rules_;
+    std::vector<Candidate> candidates_;
+    std::unordered_map<StyledNode const *, StyledNode const *> representatives_;
+};
+
+// Elements are styled before their children so that the children can share
+// styles with their cousins and inherit their computed styles.
+void style_element(
+        StyledNode &current, StyleSharingCache &sharing, RuleSet const &rules, AncestorFilter const *ancestors) {
+    if (!sharing.try_share(current)) {
+        auto [normal, custom] = matching_properties(current, rules, ancestors);
+        current.properties = std::move(normal);
+        current.custom_properties = std::move(custom);
+        sharing.insert(current);
     }
 
-    return {std::move(matched_properties), std::move(matched_custom_properties)};
+    current.compute_style();
 }
 
-namespace {
+struct StyleTreeState {
+    RuleSet const &rules;
+    AncestorFilter ancestors;
+    StyleSharingCache sharing;
+};
+
 // NOLINTNEXTLINE(misc-no-recursion)
-void style_tree_impl(StyledNode &current, css::StyleSheet const &stylesheet, css::MediaQuery::Context const &ctx) {
+void style_tree_impl(StyledNode &current, StyleTreeState &state) {
     auto const *element = std::get_if<dom::Element>(&current.node);
     if (element == nullptr) {
+        current.compute_style();
         return;
     }
 
+    style_element(current, state.sharing, state.rules, &state.ancestors);
+
     current.children.reserve(element->children.size());
+    state.ancestors.push(*element);
     for (auto const &child : element->children) {
         auto &child_node = current.children.emplace_back(child);
         child_node.parent = &current;
-        style_tree_impl(child_node, stylesheet, ctx);
+        style_tree_impl(child_node, state);
+    }
+    state.ancestors.pop(*element);
+}
+
+#ifdef __STDCPP_THREADS__
+// The number of elements in each element's subtree, including itself.
+// NOLINTNEXTLINE(misc-no-recursion)
+std::size_t count_elements(dom::Element const &element, std::unordered_map<dom::Element const *, std::size_t> &counts) {
+    std::size_t count = 1;
+    for (auto const *child : dom::dom_children(element)) {
+        count += count_elements(*child, counts);
     }
 
-    auto [normal, custom] = matching_properties(current, stylesheet, ctx);
-    current.properties = std::move(normal);
-    current.custom_properties = std::move(custom);
+    counts.emplace(&element, count);
+    return count;
 }
+
+// Styling an element only reads from its ancestors, so once the top of the tree
+// has been styled, the subtrees below it can be styled independently of each
+// other.
+//
+// The largest unstarted subtree, by element count, is split until there are a
+// few subtrees per thread, so that e.g. a <body> with a single wrapper <div>
+// is split below the wrapper rather than styled by one thread. The threads
+// then take the next subtree, largest first, that no one has started on
+// whenever they finish one. Every thread has its own ancestor filter and
+// sharing cache, and sharing only happens between equivalent elements, so the
+// result is the same no matter which thread styles what.
+void style_tree_parallel(StyledNode &root, RuleSet const &rules, std::size_t threads) {
+    static constexpr std::size_t kSubtreesPerThread = 8;
+
+    auto const *root_element = std::get_if<dom::Element>(&root.node);
+    if (root_element == nullptr) {
+        root.compute_style();
+        return;
+    }
+
+    std::unordered_map<dom::Element const *, std::size_t> element_counts;
+    count_elements(*root_element, element_counts);
+
+    struct Subtree {
+        std::size_t elements{};
+        StyledNode *node{};
+    };
+
+    // The elements at the top are styled without an ancestor filter, as it
+    // only works for depth-first traversal. Text nodes are styled right away,
+    // as they have no children to split the work over.
+    StyleSharingCache top_sharing{rules};
+    std::vector<Subtree> subtrees{{element_counts.at(root_element), &root}};
+    while (subtrees.size() < threads * kSubtreesPerThread && subtrees.front().elements > 1) {
+        std::ranges::pop_heap(subtrees, {}, &Subtree::elements);
+        auto &current = *subtrees.back().node;
+        subtrees.pop_back();
+
+        style_element(current, top_sharing, rules, nullptr);
+
+        auto const &element = std::get<dom::Element>(current.node);
+        current.children.reserve(element.children.size());
+        for (auto const &child : element.children) {
+            auto &child_node = current.children.emplace_back(child);
+            child_node.parent = &current;
+            if (auto const *child_element = std::get_if<dom::Element>(&child)) {
+                subtrees.push_back({element_counts.at(child_element), &child_node});
+                std::ranges::push_heap(subtrees, {}, &Subtree::elements);
+            } else {
+                child_node.compute_style();
+            }
+        }
+    }
+
+    std::ranges::sort(subtrees, std::ranges::greater{}, &Subtree::elements);
+    std::atomic<std::size_t> next_subtree{0};
+    auto style_subtrees = [&] {
+        StyleTreeState state{.rules = rules, .ancestors{}, .sharing = StyleSharingCache{rules}};
+        for (auto i = next_subtree++; i < subtrees.size(); i = next_subtree++) {
+            auto &subtree = *subtrees[i].node;
+            state.ancestors = {};
+            for (auto const *ancestor = subtree.parent; ancestor != nullptr; ancestor = ancestor->parent) {
+                state.ancestors.push(std::get<dom::Element>(ancestor->node));
+            }
+
+            style_tree_impl(subtree, state);
+        }
+    };
+
+    std::vector<std::future<void>> jobs;
+    jobs.reserve(threads - 1);
+    for (std::size_t i = 1; i < std::min(threads, subtrees.size()); ++i) {
+        jobs.push_back(std::async(std::launch::async, style_subtrees));
+    }
+
+    style_subtrees();
+    for (auto &job : jobs) {
+        job.get();
+    }
+}
+#endif
 } // namespace
 
-std::unique_ptr<StyledNode> style_tree(
-        dom::Node const &root, css::StyleSheet const &stylesheet, css::MediaQuery::Context const &ctx) {
+std::unique_ptr<StyledNode> style_tree(dom::Node const &root,
+        css::StyleSheet const &stylesheet,
+        css::MediaQuery::Context const &ctx,
+        std::size_t threads) {
     auto tree_root = std::make_unique<StyledNode>(root);
-    style_tree_impl(*tree_root, stylesheet, ctx);
+    RuleSet const rules{stylesheet, ctx};
+
+#ifdef __STDCPP_THREADS__
+    if (threads > 1) {
+        style_tree_parallel(*tree_root, rules, threads);
+        return tree_root;
+    }
+#else
+    std::ignore = threads;
+#endif
+
+    StyleTreeState state{.rules = rules, .ancestors{}, .sharing = StyleSharingCache{rules}};
+    style_tree_impl(*tree_root, state);
     return tree_root;
 }
 
@@ -11,6 +11,7 @@
 #include "dom/dom.h"
 #include "style/styled_node.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -19,17 +20,18 @@
 
 namespace style {
 
+// Parses the selector on every call, so this is a convenience for tests. Use
+// Selector::parse and Selector::is_match when matching more than once.
 bool is_match(StyledNode const &, std::string_view selector);
 
-struct MatchingProperties {
-    std::vector<std::pair<css::PropertyId, std::string>> normal;
-    std::vector<std::pair<std::string, std::string>> custom;
-};
-
 MatchingProperties matching_properties(StyledNode const &, css::StyleSheet const &, css::MediaQuery::Context const &);
 
-std::unique_ptr<StyledNode> style_tree(
-        dom::Node const &root, css::StyleSheet const &, css::MediaQuery::Context const & = {});
+// Styling is split across up to `threads` threads, with the result being the
+// same no matter how many are used. Platforms without threads always use one.
+std::unique_ptr<StyledNode> style_tree(dom::Node const &root,
+        css::StyleSheet const &,
+        css::MediaQuery::Context const & = {},
+        std::size_t threads = 1);
 
 } // namespace style
 
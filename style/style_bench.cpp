@@ -2,8 +2,7 @@
 //
 // SPDX-License-Identifier: BSD-2-Clause
 
-#include "style/style.h"
-
+#include "style/selector.h"
 #include "style/styled_node.h"
 
 #include "dom/dom.h"
@@ -11,6 +10,7 @@
 
 #include <nanobench.h>
 
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -26,6 +26,11 @@ void set_up_parent_ptrs(style::StyledNode &root) {
         }
     }
 }
+
+// Parsed up front so that the benchmarks only measure matching.
+style::Selector parse(std::string_view selector) {
+    return style::Selector::parse(selector).value();
+}
 } // namespace
 
 int main() {
@@ -37,12 +42,14 @@ int main() {
 
         dom::Node few_classes_dom = dom::Element{"div", {{"class", "first second"}}};
         auto few_classes = style::StyledNode{.node = few_classes_dom};
+        auto const two_classes = parse(".first.second");
         bench.run("match, few classes", [&] {
-            style::is_match(few_classes, ".first.second"); //
+            ankerl::nanobench::doNotOptimizeAway(two_classes.is_match(few_classes)); //
         });
 
+        auto const four_classes = parse(".first.second.third.fourth");
         bench.run("no match, few classes", [&] {
-            style::is_match(few_classes, ".first.second.third.fourth"); //
+            ankerl::nanobench::doNotOptimizeAway(four_classes.is_match(few_classes)); //
         });
 
         dom::Node many_classes_dom = dom::Element{
@@ -50,12 +57,14 @@ int main() {
                 {{"class", "one two three four five six seven eight nine ten"}},
         };
         auto many_classes = style::StyledNode{.node = many_classes_dom};
+        auto const present_classes = parse(".eight.two.seven.ten");
         bench.run("match, many classes", [&] {
-            style::is_match(many_classes, ".eight.two.seven.ten"); //
+            ankerl::nanobench::doNotOptimizeAway(present_classes.is_match(many_classes)); //
         });
 
+        auto const missing_class = parse(".eight.two.seve.ten");
         bench.run("no match, many classes", [&] {
-            style::is_match(many_classes, ".eight.two.seve.ten"); //
+            ankerl::nanobench::doNotOptimizeAway(missing_class.is_match(many_classes)); //
         });
     });
 
@@ -70,12 +79,14 @@ int main() {
         };
         set_up_parent_ptrs(shallow);
 
+        auto const div_span = parse("div span");
         bench.run("match, shallow", [&] {
-            a.expect_eq(style::is_match(shallow.children.back(), "div span"), true); //
+            a.expect_eq(div_span.is_match(shallow.children.back()), true); //
         });
 
+        auto const div_span_div = parse("div span div");
         bench.run("no match, shallow", [&] {
-            a.expect_eq(style::is_match(shallow.children.back(), "div span div"), false); //
+            a.expect_eq(div_span_div.is_match(shallow.children.back()), false); //
         });
 
         dom::Node deep_dom = dom::Element{"div"};
@@ -90,8 +101,9 @@ int main() {
             set_up_parent_ptrs(deep);
         }
 
+        auto const four_divs = parse("div div div div");
         bench.run("no match, 4 selectors, shallowest", [&] {
-            a.expect_eq(style::is_match(deep, "div div div div"), false); //
+            a.expect_eq(four_divs.is_match(deep), false); //
         });
 
         {
@@ -101,17 +113,17 @@ int main() {
             }
 
             bench.run("match, 4 selectors, deepest", [&] {
-                a.expect_eq(style::is_match(*deepest_node, "div div div div"), true); //
+                a.expect_eq(four_divs.is_match(*deepest_node), true); //
             });
 
+            auto const eight_divs = parse("div div div div div div div div");
             bench.run("match, 8 selectors, deepest", [&] {
-                auto match = style::is_match(*deepest_node, "div div div div div div div div");
-                a.expect_eq(match, true);
+                a.expect_eq(eight_divs.is_match(*deepest_node), true); //
             });
 
+            auto const p_and_seven_divs = parse("p div div div div div div div");
             bench.run("no match, 8 selectors, deepest", [&] {
-                auto match = style::is_match(*deepest_node, "p div div div div div div div");
-                a.expect_eq(match, false);
+                a.expect_eq(p_and_seven_divs.is_match(*deepest_node), false); //
             });
         }
     });
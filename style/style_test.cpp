@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <format>
 #include <string>
 #include <string_view>
@@ -33,6 +34,10 @@ std::vector<std::pair<css::PropertyId, std::string>> matching_rules(
     return matching_properties(style::StyledNode{element}, stylesheet, context).normal;
 }
 
+std::vector<std::pair<css::PropertyId, std::string>> declared_properties(style::StyledNode const &node) {
+    return {node.properties.begin(), node.properties.end()};
+}
+
 bool check_parents(style::StyledNode const &a, style::StyledNode const &b) {
     if (!std::ranges::equal(a.children, b.children, &check_parents)) {
         return false;
@@ -45,11 +50,16 @@ bool check_parents(style::StyledNode const &a, style::StyledNode const &b) {
     return *a.parent == *b.parent;
 }
 
+// operator== only compares the declared properties.
+bool check_computed_styles(style::StyledNode const &a, style::StyledNode const &b) {
+    return a.computed_style == b.computed_style && std::ranges::equal(a.children, b.children, &check_computed_styles);
+}
+
 void inline_css_tests(etest::Suite &s) {
     s.add_test("inline css: is applied", [](etest::IActions &a) {
         dom::Node dom = dom::Element{"div", {{"style", {"font-size:2px"}}}};
         auto styled = style::style_tree(dom, {}, {});
-        a.expect_eq(styled->properties, std::vector{std::pair{css::PropertyId::FontSize, "2px"s}});
+        a.expect_eq(declared_properties(*styled), std::vector{std::pair{css::PropertyId::FontSize, "2px"s}});
     });
 
     s.add_test("inline css: doesn't explode", [](etest::IActions &) {
@@ -62,7 +72,7 @@ void inline_css_tests(etest::Suite &s) {
         auto styled = style::style_tree(dom, {{css::Rule{{"div"}, {{css::PropertyId::FontSize, "2000px"}}}}}, {});
 
         // The last property is the one that's applied.
-        a.expect_eq(styled->properties,
+        a.expect_eq(declared_properties(*styled),
                 std::vector{
                         std::pair{css::PropertyId::FontSize, "2000px"s}, std::pair{css::PropertyId::FontSize, "2px"s}});
     });
@@ -70,7 +80,7 @@ void inline_css_tests(etest::Suite &s) {
     s.add_test("inline css: !important", [](etest::IActions &a) {
         dom::Node dom = dom::Element{"div", {{"style", {"font-size:2px !important"}}}};
         auto styled = style::style_tree(dom, {}, {});
-        a.expect_eq(styled->properties, std::vector{std::pair{css::PropertyId::FontSize, "2px"s}});
+        a.expect_eq(declared_properties(*styled), std::vector{std::pair{css::PropertyId::FontSize, "2px"s}});
     });
 }
 
@@ -85,7 +95,7 @@ void important_declarations_tests(etest::Suite &s) {
         auto styled = style::style_tree(dom, css);
 
         // The last property is the one that's applied.
-        a.expect_eq(styled->properties,
+        a.expect_eq(declared_properties(*styled),
                 std::vector{
                         std::pair{css::PropertyId::FontSize, "2px"s},
                         std::pair{css::PropertyId::FontSize, "20px"s},
@@ -357,6 +367,114 @@ int main() {
         a.expect_eq(*style::style_tree(root, stylesheet), expected);
     });
 
+    s.add_test("style_tree: style sharing", [](etest::IActions &a) {
+        // <ul><li><p/></li>...</ul> twice, with the lists distinguished by class.
+        auto make_list = [](std::string_view cls) {
+            dom::Element ul{"ul", {{"class", std::string{cls}}}};
+            ul.children.emplace_back(dom::Element{"li", {}, {dom::Element{"p"}}});
+            ul.children.emplace_back(dom::Element{"li", {}, {dom::Element{"p"}}});
+            ul.children.emplace_back(dom::Element{"li", {{"data-x", "1"}}, {dom::Element{"p"}}});
+            ul.children.emplace_back(dom::Element{"li", {{"title", "1"}}, {dom::Element{"p"}}});
+            ul.children.emplace_back(dom::Element{"li", {{"style", "width: 1px"}}, {dom::Element{"p"}}});
+            ul.children.emplace_back(dom::Element{"li", {{"id", "a"}}, {dom::Element{"p"}}});
+            return ul;
+        };
+
+        dom::Node root = dom::Element{"body", {}, {make_list("a"), make_list("b")}};
+        css::StyleSheet stylesheet{{
+                {.selectors = {"li"}, .declarations = {{css::PropertyId::Height, "1px"}}},
+                {.selectors = {".b > li p"}, .declarations = {{css::PropertyId::Color, "red"}}},
+                {.selectors = {"li[data-x] p"}, .declarations = {{css::PropertyId::Color, "blue"}}},
+                {.selectors = {"#a"}, .declarations = {{css::PropertyId::Height, "2px"}}},
+        }};
+
+        auto styled = style::style_tree(root, stylesheet);
+        a.require(styled->children.size() == 2);
+
+        auto const &a_items = styled->children[0].children;
+        auto const &b_items = styled->children[1].children;
+        a.require(a_items.size() == 6);
+        a.require(b_items.size() == 6);
+
+        for (auto const *items : {&a_items, &b_items}) {
+            for (auto const &li : *items) {
+                a.expect_eq(li.children.at(0).parent, &li);
+            }
+
+            a.expect_eq((*items)[0].get_raw_property(css::PropertyId::Height), "1px");
+            a.expect_eq((*items)[1].get_raw_property(css::PropertyId::Height), "1px");
+            a.expect_eq((*items)[3].get_raw_property(css::PropertyId::Height), "1px");
+            a.expect_eq((*items)[4].get_raw_property(css::PropertyId::Width), "1px");
+            a.expect_eq((*items)[5].get_raw_property(css::PropertyId::Height), "2px");
+            a.expect_eq((*items)[3].get_raw_property(css::PropertyId::Width), "auto");
+            a.expect_eq((*items)[5].get_raw_property(css::PropertyId::Width), "auto");
+        }
+
+        // The paragraphs in the lists have cousins with the same tag, but only
+        // the second list has the class the selector is looking for.
+        a.expect(a_items[0].children[0].properties.empty());
+        a.expect(a_items[1].children[0].properties.empty());
+        a.expect(a_items[3].children[0].properties.empty());
+        a.expect_eq(b_items[0].children[0].get_raw_property(css::PropertyId::Color), "red");
+        a.expect_eq(b_items[1].children[0].get_raw_property(css::PropertyId::Color), "red");
+        a.expect_eq(b_items[3].children[0].get_raw_property(css::PropertyId::Color), "red");
+
+        // Equivalent elements share one set of matched properties.
+        a.require(!a_items[0].properties.empty());
+        a.expect_eq(a_items[1].properties.data(), a_items[0].properties.data());
+        a.expect_eq(b_items[1].children[0].properties.data(), b_items[0].children[0].properties.data());
+        a.expect(a_items[0].children[0].properties.data() != b_items[0].children[0].properties.data());
+
+        // The paragraph under the li with an attribute a selector looks at
+        // isn't equivalent to its cousins.
+        a.expect_eq(a_items[2].children[0].get_raw_property(css::PropertyId::Color), "blue");
+        a.expect_eq(b_items[2].children[0].get_raw_property(css::PropertyId::Color), "blue");
+    });
+
+    s.add_test("style_tree: threads", [](etest::IActions &a) {
+        // Shaped like a typical page, with lots of small elements in <head>
+        // and the content in <body> inside a single wrapper.
+        dom::Element head{"head"};
+        for (int i = 0; i < 40; ++i) {
+            head.children.emplace_back(dom::Element{"meta"});
+            head.children.emplace_back(dom::Text{"\n"});
+        }
+
+        dom::Element wrapper{"div"};
+        for (int i = 0; i < 50; ++i) {
+            dom::Element section{"section", {{"class", std::format("s{}", i % 3)}}};
+            for (int j = 0; j < i; ++j) {
+                section.children.emplace_back(dom::Element{"div", {}, {dom::Element{"p"}, dom::Text{"hi"}}});
+            }
+
+            if (i % 7 == 0) {
+                section.children.emplace_back(dom::Element{"p", {{"id", std::format("p{}", i)}}});
+            }
+
+            wrapper.children.emplace_back(std::move(section));
+        }
+
+        dom::Node root =
+                dom::Element{"html", {}, {std::move(head), dom::Element{"body", {}, {std::move(wrapper)}}}};
+        css::StyleSheet stylesheet{{
+                {.selectors = {"p"}, .declarations = {{css::PropertyId::Height, "1px"}}},
+                {.selectors = {".s1 p"}, .declarations = {{css::PropertyId::Color, "red"}}},
+                {.selectors = {".s2 > div > p"}, .declarations = {{css::PropertyId::Color, "blue"}}},
+                {.selectors = {"#p14"}, .declarations = {{css::PropertyId::Width, "2px"}}},
+                {.selectors = {"html section"}, .declarations = {{css::PropertyId::Display, "block"}}},
+                {.selectors = {".s0"},
+                        .declarations = {{css::PropertyId::FontSize, "2em"}, {css::PropertyId::FontWeight, "bolder"}}},
+        }};
+
+        auto const expected = style::style_tree(root, stylesheet);
+        for (std::size_t threads : {2, 3, 16, 1000}) {
+            auto const styled = style::style_tree(root, stylesheet, {}, threads);
+            a.expect(*styled == *expected);
+            a.expect(check_parents(*styled, *expected));
+            a.expect(check_computed_styles(*styled, *expected));
+        }
+    });
+
     inline_css_tests(s);
     important_declarations_tests(s);
     attribute_selector_matching(s);
@@ -202,6 +202,16 @@ std::optional<std::pair<float, std::string_view>> split_into_value_and_unit(std:
     return std::pair{res, unit};
 }
 
+std::pair<int, int> resolve_border_radius(std::string_view raw, int font_size, int root_font_size) {
+    auto [horizontal, vertical] = raw.contains('/') ? util::split_once(raw, '/') : std::pair{raw, raw};
+    auto horizontal_prop = UnresolvedValue{horizontal};
+    auto vertical_prop = UnresolvedValue{vertical};
+    return {
+            horizontal_prop.resolve(font_size, {.root_font_size = root_font_size}),
+            vertical_prop.resolve(font_size, {.root_font_size = root_font_size}),
+    };
+}
+
 // https://drafts.csswg.org/css-backgrounds/#the-border-width
 constexpr auto kBorderWidthKeywords = std::to_array<std::pair<std::string_view, int>>({
         {"thin", 3},
@@ -227,17 +237,18 @@ int UnresolvedBorderWidth::resolve(
 std::string_view StyledNode::get_raw_property(css::PropertyId property) const {
     // We don't support selector specificity yet, so the last property is found
     // in order to allow website style to override the browser built-in style.
+    auto const &declared = properties;
     auto it = std::ranges::find_if(
-            rbegin(properties), rend(properties), [=](auto const &p) { return p.first == property; });
+            rbegin(declared), rend(declared), [=](auto const &p) { return p.first == property; });
 
     // TODO(robinlinden): Having a special case for dom::Text here doesn't feel good.
     // You can't set properties on text nodes in HTML (even though we do in
     // tests), so let's grab this from the parent node.
-    if (it == rend(properties) && std::holds_alternative<dom::Text>(node) && parent != nullptr) {
+    if (it == rend(declared) && std::holds_alternative<dom::Text>(node) && parent != nullptr) {
         return parent->get_raw_property(property);
     }
 
-    if (it == rend(properties) || it->second == "unset") {
+    if (it == rend(declared) || it->second == "unset") {
         // https://developer.mozilla.org/en-US/docs/Web/CSS/unset
         if (is_inherited(property) && parent != nullptr) {
             return parent->get_raw_property(property);
@@ -286,9 +297,9 @@ std::optional<std::string_view> StyledNode::resolve_variable(std::string_view va
 
         std::optional<std::string_view> prop;
         for (auto const *current = this; current != nullptr; current = current->parent) {
-            auto p = std::ranges::find(
-                    current->custom_properties, var_name, &std::pair<std::string, std::string>::first);
-            if (p == end(current->custom_properties)) {
+            auto const &declared = current->custom_properties;
+            auto p = std::ranges::find(declared, var_name, &std::pair<std::string, std::string>::first);
+            if (p == end(declared)) {
                 continue;
             }
 
@@ -324,6 +335,23 @@ std::optional<std::string_view> StyledNode::resolve_variable(std::string_view va
 }
 
 BorderStyle StyledNode::get_border_style_property(css::PropertyId property) const {
+    if (computed_style.has_value()) {
+        switch (property) {
+            case css::PropertyId::BorderBottomStyle:
+                return computed_style->border_bottom_style;
+            case css::PropertyId::BorderLeftStyle:
+                return computed_style->border_left_style;
+            case css::PropertyId::BorderRightStyle:
+                return computed_style->border_right_style;
+            case css::PropertyId::BorderTopStyle:
+                return computed_style->border_top_style;
+            case css::PropertyId::OutlineStyle:
+                return computed_style->outline_style;
+            default:
+                break;
+        }
+    }
+
     auto raw = get_raw_property(property);
 
     if (raw == "none") {
@@ -371,6 +399,27 @@ BorderStyle StyledNode::get_border_style_property(css::PropertyId property) cons
 }
 
 gfx::Color StyledNode::get_color_property(css::PropertyId property) const {
+    if (computed_style.has_value()) {
+        switch (property) {
+            case css::PropertyId::BackgroundColor:
+                return computed_style->background_color;
+            case css::PropertyId::BorderBottomColor:
+                return computed_style->border_bottom_color;
+            case css::PropertyId::BorderLeftColor:
+                return computed_style->border_left_color;
+            case css::PropertyId::BorderRightColor:
+                return computed_style->border_right_color;
+            case css::PropertyId::BorderTopColor:
+                return computed_style->border_top_color;
+            case css::PropertyId::Color:
+                return computed_style->color;
+            case css::PropertyId::OutlineColor:
+                return computed_style->outline_color;
+            default:
+                break;
+        }
+    }
+
     auto color_text = get_raw_property(property);
 
     // https://developer.mozilla.org/en-US/docs/Web/CSS/color_value#currentcolor_keyword
@@ -384,6 +433,10 @@ gfx::Color StyledNode::get_color_property(css::PropertyId property) const {
 // https://developer.mozilla.org/en-US/docs/Web/CSS/float
 // ^ has info about the weird float<->display property interaction.
 std::optional<Display> StyledNode::get_display_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->display;
+    }
+
     // TODO(robinlinden): Special-case for text not needed once the special case
     // where we get the parent properties for text in get_raw_property is
     // removed.
@@ -413,6 +466,10 @@ std::optional<Display> StyledNode::get_display_property() const {
 }
 
 std::optional<Float> StyledNode::get_float_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->float_value;
+    }
+
     auto raw = get_raw_property(css::PropertyId::Float);
     if (raw == "none") {
         return Float::None;
@@ -437,7 +494,24 @@ std::optional<Float> StyledNode::get_float_property() const {
     return std::nullopt;
 }
 
+FontFamilies StyledNode::get_font_family_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->font_family;
+    }
+
+    auto families = util::split(get_raw_property(css::PropertyId::FontFamily), ",");
+    static constexpr auto kShouldTrim = [](char c) {
+        return util::is_whitespace(c) || c == '\'' || c == '"';
+    };
+    std::ranges::for_each(families, [](auto &family) { family = util::trim(family, kShouldTrim); });
+    return FontFamilies{families};
+}
+
 FontStyle StyledNode::get_font_style_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->font_style;
+    }
+
     auto raw = get_raw_property(css::PropertyId::FontStyle);
     if (raw == "normal") {
         return FontStyle::Normal;
@@ -456,6 +530,10 @@ FontStyle StyledNode::get_font_style_property() const {
 }
 
 TextAlign StyledNode::get_text_align_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->text_align;
+    }
+
     auto raw = get_raw_property(css::PropertyId::TextAlign);
     if (raw == "left") {
         return TextAlign::Left;
@@ -480,6 +558,10 @@ TextAlign StyledNode::get_text_align_property() const {
 }
 
 std::vector<TextDecorationLine> StyledNode::get_text_decoration_line_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->text_decoration_line;
+    }
+
     auto into = [](std::string_view v) -> std::optional<TextDecorationLine> {
         if (v == "none") {
             return TextDecorationLine::None;
@@ -521,6 +603,10 @@ std::vector<TextDecorationLine> StyledNode::get_text_decoration_line_property()
 }
 
 std::optional<TextTransform> StyledNode::get_text_transform_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->text_transform;
+    }
+
     auto raw = get_raw_property(css::PropertyId::TextTransform);
     if (raw == "none") {
         return TextTransform::None;
@@ -568,13 +654,18 @@ constexpr auto kFontSizeAbsoluteSizeKeywords = std::to_array<std::pair<std::stri
 
 // NOLINTNEXTLINE(misc-no-recursion)
 int StyledNode::get_font_size_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->font_size;
+    }
+
     auto get_closest_font_size_and_owner =
             [](StyledNode const *starting_node) -> std::optional<std::pair<std::string_view, StyledNode const *>> {
         for (auto const *n = starting_node; n != nullptr; n = n->parent) {
-            auto it = std::ranges::find_if(rbegin(n->properties), rend(n->properties), [](auto const &v) {
+            auto const &declared = n->properties;
+            auto it = std::ranges::find_if(rbegin(declared), rend(declared), [](auto const &v) {
                 return v.first == css::PropertyId::FontSize;
             });
-            if (it != rend(n->properties) && it->second != "inherit" && it->second != "unset") {
+            if (it != rend(declared) && it->second != "inherit" && it->second != "unset") {
                 return {{it->second, n}};
             }
         }
@@ -681,6 +772,22 @@ int StyledNode::get_font_size_property() const {
 // https://drafts.csswg.org/css-fonts-4/#font-weight-prop
 // NOLINTNEXTLINE(misc-no-recursion)
 std::optional<FontWeight> StyledNode::get_font_weight_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->font_weight;
+    }
+
+    // An inherited weight is the parent's resolved one rather than its
+    // keyword, or bolder and lighter would be applied once more.
+    if (parent != nullptr) {
+        auto const &declared = properties;
+        auto it = std::ranges::find_if(rbegin(declared), rend(declared), [](auto const &p) {
+            return p.first == css::PropertyId::FontWeight;
+        });
+        if (it == rend(declared) || it->second == "inherit" || it->second == "unset") {
+            return parent->get_font_weight_property();
+        }
+    }
+
     auto raw = get_raw_property(css::PropertyId::FontWeight);
     if (raw == "normal") {
         return FontWeight::normal();
@@ -756,6 +863,10 @@ std::optional<FontWeight> StyledNode::get_font_weight_property() const {
 }
 
 std::optional<WhiteSpace> StyledNode::get_white_space_property() const {
+    if (computed_style.has_value()) {
+        return computed_style->white_space;
+    }
+
     auto raw = get_raw_property(css::PropertyId::WhiteSpace);
     if (raw == "normal") {
         return WhiteSpace::Normal;
@@ -786,17 +897,119 @@ std::optional<WhiteSpace> StyledNode::get_white_space_property() const {
 }
 
 std::pair<int, int> StyledNode::get_border_radius_property(css::PropertyId id) const {
-    auto raw = get_raw_property(id);
-    auto [horizontal, vertical] = raw.contains('/') ? util::split_once(raw, '/') : std::pair{raw, raw};
-    auto horizontal_prop = UnresolvedValue{horizontal};
-    auto vertical_prop = UnresolvedValue{vertical};
+    if (computed_style.has_value()) {
+        switch (id) {
+            case css::PropertyId::BorderBottomLeftRadius:
+                return computed_style->border_bottom_left_radius;
+            case css::PropertyId::BorderBottomRightRadius:
+                return computed_style->border_bottom_right_radius;
+            case css::PropertyId::BorderTopLeftRadius:
+                return computed_style->border_top_left_radius;
+            case css::PropertyId::BorderTopRightRadius:
+                return computed_style->border_top_right_radius;
+            default:
+                break;
+        }
+    }
 
-    int font_size = get_property<css::PropertyId::FontSize>();
-    int root_font_size = get_root_font_size(*this);
-    return {
-            horizontal_prop.resolve(font_size, {.root_font_size = root_font_size}),
-            vertical_prop.resolve(font_size, {.root_font_size = root_font_size}),
+    return resolve_border_radius(
+            get_raw_property(id), get_property<css::PropertyId::FontSize>(), get_root_font_size(*this));
+}
+
+void StyledNode::compute_style() {
+    computed_style.reset();
+    ComputedStyle const *parent_style =
+            parent != nullptr && parent->computed_style.has_value() ? &*parent->computed_style : nullptr;
+
+    auto own_value = [&declared = properties](css::PropertyId property) -> std::optional<std::string_view> {
+        auto it = std::ranges::find_if(
+                rbegin(declared), rend(declared), [=](auto const &p) { return p.first == property; });
+        if (it == rend(declared)) {
+            return std::nullopt;
+        }
+
+        return it->second;
+    };
+
+    // Inherited properties this node doesn't set have the same value as in the
+    // parent, and text nodes get everything they don't set from the parent.
+    auto uses_parent_value = [&](css::PropertyId property) {
+        if (parent_style == nullptr) {
+            return false;
+        }
+
+        auto value = own_value(property);
+        if (!value) {
+            return css::is_inherited(property) || std::holds_alternative<dom::Text>(node);
+        }
+
+        return *value == "unset" && css::is_inherited(property);
     };
+
+    ComputedStyle style;
+    auto resolve = [&]<typename T>(T ComputedStyle::*member, css::PropertyId property, auto const &compute) {
+        style.*member = uses_parent_value(property) ? parent_style->*member : compute(property);
+    };
+
+    auto color = [&](css::PropertyId property) {
+        // Resolved here rather than by looking up the color again, as that
+        // would walk up the tree for every element that doesn't set it.
+        auto value = own_value(property).value_or(css::initial_value(property));
+        if (property != css::PropertyId::Color && value == "currentcolor") {
+            return style.color;
+        }
+
+        return get_color_property(property);
+    };
+    auto border_style = [&](css::PropertyId property) { return get_border_style_property(property); };
+    auto border_radius = [&](css::PropertyId property) {
+        return resolve_border_radius(get_raw_property(property), style.font_size, style.root_font_size);
+    };
+
+    // Color and font-size first, as other values depend on them.
+    resolve(&ComputedStyle::color, css::PropertyId::Color, color);
+    resolve(&ComputedStyle::font_size, css::PropertyId::FontSize, [&](auto) { return get_font_size_property(); });
+    style.root_font_size = parent_style != nullptr ? parent_style->root_font_size : style.font_size;
+
+    resolve(&ComputedStyle::background_color, css::PropertyId::BackgroundColor, color);
+    resolve(&ComputedStyle::border_bottom_color, css::PropertyId::BorderBottomColor, color);
+    resolve(&ComputedStyle::border_left_color, css::PropertyId::BorderLeftColor, color);
+    resolve(&ComputedStyle::border_right_color, css::PropertyId::BorderRightColor, color);
+    resolve(&ComputedStyle::border_top_color, css::PropertyId::BorderTopColor, color);
+    resolve(&ComputedStyle::outline_color, css::PropertyId::OutlineColor, color);
+    resolve(&ComputedStyle::border_bottom_style, css::PropertyId::BorderBottomStyle, border_style);
+    resolve(&ComputedStyle::border_left_style, css::PropertyId::BorderLeftStyle, border_style);
+    resolve(&ComputedStyle::border_right_style, css::PropertyId::BorderRightStyle, border_style);
+    resolve(&ComputedStyle::border_top_style, css::PropertyId::BorderTopStyle, border_style);
+    resolve(&ComputedStyle::outline_style, css::PropertyId::OutlineStyle, border_style);
+    resolve(&ComputedStyle::border_bottom_left_radius, css::PropertyId::BorderBottomLeftRadius, border_radius);
+    resolve(&ComputedStyle::border_bottom_right_radius, css::PropertyId::BorderBottomRightRadius, border_radius);
+    resolve(&ComputedStyle::border_top_left_radius, css::PropertyId::BorderTopLeftRadius, border_radius);
+    resolve(&ComputedStyle::border_top_right_radius, css::PropertyId::BorderTopRightRadius, border_radius);
+
+    // Text is always inline, so this is never taken from the parent.
+    style.display = get_display_property();
+    resolve(&ComputedStyle::float_value, css::PropertyId::Float, [&](auto) { return get_float_property(); });
+    // Only the node declaring the families stores them, and the ones
+    // inheriting them share its list.
+    style.font_family = uses_parent_value(css::PropertyId::FontFamily) ? parent_style->font_family
+                                                                       : get_font_family_property();
+    resolve(&ComputedStyle::font_style, css::PropertyId::FontStyle, [&](auto) { return get_font_style_property(); });
+    resolve(&ComputedStyle::font_weight, css::PropertyId::FontWeight, [&](auto) {
+        return get_font_weight_property();
+    });
+    resolve(&ComputedStyle::text_align, css::PropertyId::TextAlign, [&](auto) { return get_text_align_property(); });
+    resolve(&ComputedStyle::text_decoration_line, css::PropertyId::TextDecorationLine, [&](auto) {
+        return get_text_decoration_line_property();
+    });
+    resolve(&ComputedStyle::text_transform, css::PropertyId::TextTransform, [&](auto) {
+        return get_text_transform_property();
+    });
+    resolve(&ComputedStyle::white_space, css::PropertyId::WhiteSpace, [&](auto) {
+        return get_white_space_property();
+    });
+
+    computed_style = std::move(style);
 }
 
 } // namespace style
@@ -10,11 +10,15 @@
 #include "css/property_id.h"
 #include "dom/dom.h"
 #include "gfx/color.h"
-#include "util/string.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <memory>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -117,16 +121,158 @@ struct UnresolvedBorderWidth {
     int resolve(int font_size, ResolutionInfo, std::optional<int> percent_relative_to = std::nullopt) const;
 };
 
+// The families named by a font-family value. Copies share the list, so nodes
+// inheriting it hold a reference to it instead of storing their own.
+class FontFamilies {
+public:
+    FontFamilies() = default;
+    explicit FontFamilies(std::vector<std::string_view> const &families)
+        : families_{std::make_shared<Families const>(families)} {}
+
+    [[nodiscard]] auto begin() const { return view().begin(); }
+    [[nodiscard]] auto end() const { return view().end(); }
+    [[nodiscard]] std::size_t size() const { return view().size(); }
+    [[nodiscard]] bool empty() const { return view().empty(); }
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator std::span<std::string_view const>() const { return view(); }
+
+    [[nodiscard]] bool operator==(FontFamilies const &other) const { return std::ranges::equal(*this, other); }
+
+private:
+    struct Families {
+        explicit Families(std::vector<std::string_view> const &families)
+            : names{families.begin(), families.end()}, views{names.begin(), names.end()} {}
+
+        // The views point into names, so this must never be copied or moved.
+        Families(Families const &) = delete;
+        Families &operator=(Families const &) = delete;
+        Families(Families &&) = delete;
+        Families &operator=(Families &&) = delete;
+        ~Families() = default;
+
+        std::vector<std::string> names;
+        std::vector<std::string_view> views;
+    };
+
+    std::span<std::string_view const> view() const {
+        return families_ ? std::span<std::string_view const>{families_->views} : std::span<std::string_view const>{};
+    }
+
+    std::shared_ptr<Families const> families_;
+};
+
+// The typed values of the properties that need parsing or inheritance to be
+// resolved, computed once per node so that layout and render can look them up
+// as often as they like.
+struct ComputedStyle {
+    gfx::Color background_color;
+    gfx::Color border_bottom_color;
+    gfx::Color border_left_color;
+    gfx::Color border_right_color;
+    gfx::Color border_top_color;
+    gfx::Color color;
+    gfx::Color outline_color;
+    BorderStyle border_bottom_style{};
+    BorderStyle border_left_style{};
+    BorderStyle border_right_style{};
+    BorderStyle border_top_style{};
+    BorderStyle outline_style{};
+    std::pair<int, int> border_bottom_left_radius{};
+    std::pair<int, int> border_bottom_right_radius{};
+    std::pair<int, int> border_top_left_radius{};
+    std::pair<int, int> border_top_right_radius{};
+    std::optional<Display> display;
+    std::optional<Float> float_value;
+    FontFamilies font_family;
+    int font_size{};
+    int root_font_size{};
+    FontStyle font_style{};
+    std::optional<FontWeight> font_weight;
+    TextAlign text_align{};
+    std::vector<TextDecorationLine> text_decoration_line;
+    std::optional<TextTransform> text_transform;
+    std::optional<WhiteSpace> white_space;
+
+    [[nodiscard]] bool operator==(ComputedStyle const &) const = default;
+};
+
+struct MatchingProperties {
+    std::vector<std::pair<css::PropertyId, std::string>> normal;
+    std::vector<std::pair<std::string, std::string>> custom;
+};
+
+// A list of declared properties that copies share until one of them is changed,
+// letting equivalent elements share the properties matched for one of them.
+template<typename T>
+class SharedProperties {
+public:
+    SharedProperties() = default;
+    // NOLINTBEGIN(google-explicit-constructor): Used in place of a std::vector.
+    SharedProperties(std::initializer_list<T> values) : values_{std::make_shared<std::vector<T>>(values)} {}
+    SharedProperties(std::vector<T> values) : values_{std::make_shared<std::vector<T>>(std::move(values))} {}
+    operator std::span<T const>() const { return view(); }
+    // NOLINTEND(google-explicit-constructor)
+
+    [[nodiscard]] std::span<T const> view() const {
+        return values_ ? std::span<T const>{*values_} : std::span<T const>{};
+    }
+
+    [[nodiscard]] auto begin() const { return view().begin(); }
+    [[nodiscard]] auto end() const { return view().end(); }
+    [[nodiscard]] auto rbegin() const { return view().rbegin(); }
+    [[nodiscard]] auto rend() const { return view().rend(); }
+    [[nodiscard]] T const *data() const { return view().data(); }
+    [[nodiscard]] std::size_t size() const { return view().size(); }
+    [[nodiscard]] bool empty() const { return view().empty(); }
+    [[nodiscard]] T const &operator[](std::size_t i) const { return view()[i]; }
+
+    // Changing the properties first copies them if they're shared.
+    [[nodiscard]] T &operator[](std::size_t i) { return mutable_values()[i]; }
+    [[nodiscard]] T &at(std::size_t i) { return mutable_values().at(i); }
+    void clear() { values_.reset(); }
+
+    template<typename... Args>
+    T &emplace_back(Args &&...args) {
+        return mutable_values().emplace_back(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] bool operator==(SharedProperties const &other) const {
+        return std::ranges::equal(view(), other.view());
+    }
+
+private:
+    std::vector<T> &mutable_values() {
+        if (!values_) {
+            values_ = std::make_shared<std::vector<T>>();
+        } else if (values_.use_count() > 1) {
+            values_ = std::make_shared<std::vector<T>>(*values_);
+        }
+
+        return *values_;
+    }
+
+    std::shared_ptr<std::vector<T>> values_;
+};
+
 // NOLINTNEXTLINE(misc-no-recursion)
 struct StyledNode {
     dom::Node const &node;
-    std::vector<std::pair<css::PropertyId, std::string>> properties;
+    SharedProperties<std::pair<css::PropertyId, std::string>> properties;
     std::vector<StyledNode> children;
     StyledNode const *parent{nullptr};
-    std::vector<std::pair<std::string, std::string>> custom_properties;
+    SharedProperties<std::pair<std::string, std::string>> custom_properties;
+    // Filled in by style_tree. Nodes without one resolve their properties
+    // every time they're asked for them.
+    std::optional<ComputedStyle> computed_style;
 
     std::string_view get_raw_property(css::PropertyId) const;
 
+    // Resolves the values in ComputedStyle from the properties. The parent's
+    // style has to be computed first for inherited values to be taken from it
+    // rather than looked up through every ancestor.
+    void compute_style();
+
     template<css::PropertyId T>
     auto get_property() const {
         if constexpr (T == css::PropertyId::BackgroundColor || T == css::PropertyId::BorderBottomColor
@@ -143,13 +289,7 @@ struct StyledNode {
         } else if constexpr (T == css::PropertyId::Float) {
             return get_float_property();
         } else if constexpr (T == css::PropertyId::FontFamily) {
-            auto raw_font_family = get_raw_property(T);
-            auto families = util::split(raw_font_family, ",");
-            static constexpr auto kShouldTrim = [](char c) {
-                return util::is_whitespace(c) || c == '\'' || c == '"';
-            };
-            std::ranges::for_each(families, [](auto &family) { family = util::trim(family, kShouldTrim); });
-            return families;
+            return get_font_family_property();
         } else if constexpr (T == css::PropertyId::FontSize) {
             return get_font_size_property();
         } else if constexpr (T == css::PropertyId::FontStyle) {
@@ -189,6 +329,7 @@ private:
 
     BorderStyle get_border_style_property(css::PropertyId) const;
     gfx::Color get_color_property(css::PropertyId) const;
+    FontFamilies get_font_family_property() const;
     std::optional<Display> get_display_property() const;
     std::optional<Float> get_float_property() const;
     FontStyle get_font_style_property() const;
@@ -212,16 +353,10 @@ inline std::string_view dom_name(StyledNode const &node) {
     return std::get<dom::Element>(node.node).name;
 }
 
-inline std::vector<StyledNode const *> dom_children(StyledNode const &node) {
-    std::vector<StyledNode const *> children{};
-    for (auto const &child : node.children) {
-        if (!std::holds_alternative<dom::Element>(child.node)) {
-            continue;
-        }
-
-        children.push_back(&child);
-    }
-    return children;
+inline auto dom_children(StyledNode const &node) {
+    auto is_element = [](StyledNode const &child) { return std::holds_alternative<dom::Element>(child.node); };
+    auto to_pointer = [](StyledNode const &child) { return &child; };
+    return node.children | std::views::filter(is_element) | std::views::transform(to_pointer);
 }
 
 template<css::PropertyId T>
@@ -12,6 +12,7 @@
 #include "etest/etest2.h"
 #include "gfx/color.h"
 
+#include <array>
 #include <optional>
 #include <source_location>
 #include <string>
@@ -59,6 +60,46 @@ void expect_relative_property_eq(etest::IActions &a,
 
     a.expect_eq(styled_node.children.at(0).get_property<IdT>(), expected, std::nullopt, loc);
 };
+
+// What the uncached getters return, to make sure computing the style up front
+// gives the same result.
+style::ComputedStyle resolve_style(style::StyledNode const &node) {
+    using enum css::PropertyId;
+    auto const *root = &node;
+    while (root->parent != nullptr) {
+        root = root->parent;
+    }
+
+    return {
+            .background_color = node.get_property<BackgroundColor>(),
+            .border_bottom_color = node.get_property<BorderBottomColor>(),
+            .border_left_color = node.get_property<BorderLeftColor>(),
+            .border_right_color = node.get_property<BorderRightColor>(),
+            .border_top_color = node.get_property<BorderTopColor>(),
+            .color = node.get_property<Color>(),
+            .outline_color = node.get_property<OutlineColor>(),
+            .border_bottom_style = node.get_property<BorderBottomStyle>(),
+            .border_left_style = node.get_property<BorderLeftStyle>(),
+            .border_right_style = node.get_property<BorderRightStyle>(),
+            .border_top_style = node.get_property<BorderTopStyle>(),
+            .outline_style = node.get_property<OutlineStyle>(),
+            .border_bottom_left_radius = node.get_property<BorderBottomLeftRadius>(),
+            .border_bottom_right_radius = node.get_property<BorderBottomRightRadius>(),
+            .border_top_left_radius = node.get_property<BorderTopLeftRadius>(),
+            .border_top_right_radius = node.get_property<BorderTopRightRadius>(),
+            .display = node.get_property<Display>(),
+            .float_value = node.get_property<Float>(),
+            .font_family = node.get_property<FontFamily>(),
+            .font_size = node.get_property<FontSize>(),
+            .root_font_size = root->get_property<FontSize>(),
+            .font_style = node.get_property<FontStyle>(),
+            .font_weight = node.get_property<FontWeight>(),
+            .text_align = node.get_property<TextAlign>(),
+            .text_decoration_line = node.get_property<TextDecorationLine>(),
+            .text_transform = node.get_property<TextTransform>(),
+            .white_space = node.get_property<WhiteSpace>(),
+    };
+}
 } // namespace
 
 int main() {
@@ -198,12 +239,12 @@ int main() {
     });
 
     s.add_test("get_font_family_property", [](etest::IActions &a) {
-        using FontFamilies = std::vector<std::string_view>;
-        expect_property_eq<css::PropertyId::FontFamily>(a, "abc, def", FontFamilies{"abc", "def"});
-        expect_property_eq<css::PropertyId::FontFamily>(a, R"('abc', "def")", FontFamilies{"abc", "def"});
-        expect_property_eq<css::PropertyId::FontFamily>(a, "arial", FontFamilies{"arial"});
-        expect_property_eq<css::PropertyId::FontFamily>(a, "'arial'", FontFamilies{"arial"});
-        expect_property_eq<css::PropertyId::FontFamily>(a, R"("arial")", FontFamilies{"arial"});
+        using style::FontFamilies;
+        expect_property_eq<css::PropertyId::FontFamily>(a, "abc, def", FontFamilies{{"abc", "def"}});
+        expect_property_eq<css::PropertyId::FontFamily>(a, R"('abc', "def")", FontFamilies{{"abc", "def"}});
+        expect_property_eq<css::PropertyId::FontFamily>(a, "arial", FontFamilies{{"arial"}});
+        expect_property_eq<css::PropertyId::FontFamily>(a, "'arial'", FontFamilies{{"arial"}});
+        expect_property_eq<css::PropertyId::FontFamily>(a, R"("arial")", FontFamilies{{"arial"}});
     });
 
     s.add_test("get_font_size_property", [](etest::IActions &a) {
@@ -494,6 +535,46 @@ int main() {
         a.expect_eq(styled_node.get_property<css::PropertyId::FontWeight>(), style::FontWeight{100});
     });
 
+    s.add_test("font-weight, inherited relative weight", [](etest::IActions &a) {
+        dom::Node dom = dom::Element{"baka"};
+        auto check = [&](std::optional<std::string> grandparent_weight,
+                             std::string parent_weight,
+                             style::FontWeight expected,
+                             std::source_location const &loc = std::source_location::current()) {
+            style::StyledNode grandparent{.node = dom};
+            if (grandparent_weight) {
+                grandparent.properties.emplace_back(FontWeight, std::move(*grandparent_weight));
+            }
+
+            auto &parent = grandparent.children.emplace_back(
+                    style::StyledNode{.node = dom, .properties{{FontWeight, std::move(parent_weight)}}});
+            parent.parent = &grandparent;
+            parent.children.reserve(2);
+            auto &child = parent.children.emplace_back(style::StyledNode{.node = dom});
+            child.parent = &parent;
+            auto &inheriting_child = parent.children.emplace_back(
+                    style::StyledNode{.node = dom, .properties{{FontWeight, "inherit"}}});
+            inheriting_child.parent = &parent;
+
+            // The keyword applies to the parent, and the children get its result.
+            a.expect_eq(parent.get_property<FontWeight>(), expected, std::nullopt, loc);
+            a.expect_eq(child.get_property<FontWeight>(), expected, std::nullopt, loc);
+            a.expect_eq(inheriting_child.get_property<FontWeight>(), expected, std::nullopt, loc);
+
+            for (auto *node : {&grandparent, &parent, &child, &inheriting_child}) {
+                node->compute_style();
+            }
+
+            a.expect_eq(child.get_property<FontWeight>(), expected, std::nullopt, loc);
+            a.expect_eq(inheriting_child.get_property<FontWeight>(), expected, std::nullopt, loc);
+        };
+
+        check(std::nullopt, "bolder", style::FontWeight::bold());
+        check("bold", "bolder", style::FontWeight{900});
+        check(std::nullopt, "lighter", style::FontWeight{100});
+        check("bold", "lighter", style::FontWeight::normal());
+    });
+
     s.add_test("var", [](etest::IActions &a) {
         dom::Node dom = dom::Element{"baka"};
         style::StyledNode styled_node{
@@ -659,6 +740,88 @@ int main() {
         expect_property_eq<MaxWidth>(a, "none", style::UnresolvedValue{"none"});
     });
 
+    s.add_test("compute_style", [](etest::IActions &a) {
+        dom::Node dom_node = dom::Element{"dummy"s};
+        dom::Node text_node = dom::Text{"hello"s};
+        style::StyledNode root{
+                .node = dom_node,
+                .properties{
+                        {FontSize, "20px"},
+                        {Color, "blue"},
+                        {FontFamily, "a, 'b'"},
+                        {BorderTopLeftRadius, "1rem"},
+                        {TextAlign, "center"},
+                },
+                .children{
+                        {.node = dom_node,
+                                .properties{
+                                        {FontSize, "2em"},
+                                        {Display, "inline"},
+                                        {Float, "left"},
+                                        {FontWeight, "bold"},
+                                        {WhiteSpace, "pre"},
+                                        {BorderBottomColor, "red"},
+                                        {BorderBottomLeftRadius, "1em / 2px"},
+                                        {TextAlign, "unset"},
+                                }},
+                },
+        };
+        auto &div = root.children[0];
+        div.parent = &root;
+        div.children.push_back({
+                .node = dom_node,
+                .properties{
+                        {TextDecorationLine, "underline"},
+                        {BackgroundColor, "#123456"},
+                        {OutlineColor, "currentcolor"},
+                        {Color, "inherit"},
+                        {FontWeight, "bolder"},
+                },
+        });
+        auto &p = div.children[0];
+        p.parent = &div;
+        p.children.push_back({.node = text_node, .parent = &p});
+        auto &text = p.children[0];
+
+        auto const expected = std::array{
+                resolve_style(root),
+                resolve_style(div),
+                resolve_style(p),
+                resolve_style(text),
+        };
+
+        for (auto *node : {&root, &div, &p, &text}) {
+            node->compute_style();
+        }
+
+        a.expect(root.computed_style == expected[0]);
+        a.expect(div.computed_style == expected[1]);
+        a.expect(p.computed_style == expected[2]);
+        a.expect(text.computed_style == expected[3]);
+
+        a.expect_eq(div.computed_style->font_size, 40);
+        a.expect_eq(p.computed_style->root_font_size, 20);
+        a.expect_eq(p.computed_style->outline_color, gfx::Color{0, 0, 0xff});
+        a.expect_eq(text.computed_style->display, style::Display::inline_flow());
+        a.expect_eq(text.computed_style->background_color, gfx::Color::from_rgb(0x123456));
+
+        // Only the root stores the font families, and its descendants share them.
+        a.expect(&*text.get_property<FontFamily>().begin() == &*root.get_property<FontFamily>().begin());
+
+        // The getters don't look at the properties once the style is computed.
+        p.properties.clear();
+        a.expect_eq(p.get_property<TextDecorationLine>(), std::vector{style::TextDecorationLine::Underline});
+        a.expect_eq(p.get_property<FontFamily>(), style::FontFamilies{{"a", "b"}});
+        a.expect_eq(p.get_property<FontWeight>(), style::FontWeight{900});
+
+        // Copies of a subtree keep the shared families after the node declaring them is restyled.
+        auto const copy = div;
+        root.properties = {{FontFamily, "c"}};
+        root.compute_style();
+        a.expect_eq(root.get_property<FontFamily>(), style::FontFamilies{{"c"}});
+        a.expect_eq(copy.children[0].children[0].get_property<FontFamily>(), style::FontFamilies{{"a", "b"}});
+    });
+
     s.add_test("style::initial_value", [](etest::IActions &a) {
         a.expect_eq(style::initial_value<css::PropertyId::Width>(), style::UnresolvedValue{"auto"});
         a.expect_eq(style::initial_value<css::PropertyId::FontSize>(), 16);
@@ -63,7 +63,9 @@ std::optional<Uri> parse_uri(std::string uristr) {
         }
     }
 
-    if (auto host_end = hostport.find_first_of(':'); host_end != std::string::npos) {
+    // IPv6 addresses contain colons, so they're wrapped in brackets.
+    auto const host_start = hostport.starts_with('[') ? hostport.find_first_of(']') : 0;
+    if (auto host_end = hostport.find_first_of(':', host_start); host_end != std::string::npos) {
         // Port present.
         authority.host = hostport.substr(0, host_end);
         authority.port = hostport.substr(host_end + 1);
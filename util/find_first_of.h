@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef UTIL_FIND_FIRST_OF_H_
+#define UTIL_FIND_FIRST_OF_H_
+
+#include <cstddef>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <bit>
+
+#include <emmintrin.h>
+#endif
+
+namespace util {
+
+// Like std::string_view::find_first_of, but with the characters to look for
+// known at compile time, allowing for 16 bytes to be checked at a time where
+// SSE2 is available.
+template<char... Cs>
+requires(sizeof...(Cs) > 0)
+constexpr std::size_t find_first_of(std::string_view s, std::size_t pos = 0) {
+    if (pos >= s.size()) {
+        return std::string_view::npos;
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    if !consteval {
+        for (; pos + 16 <= s.size(); pos += 16) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            auto const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(s.data() + pos));
+            auto matches = _mm_setzero_si128();
+            ((matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Cs)))), ...);
+            if (auto const mask = static_cast<unsigned>(_mm_movemask_epi8(matches)); mask != 0) {
+                return pos + static_cast<std::size_t>(std::countr_zero(mask));
+            }
+        }
+    }
+#endif
+
+    for (; pos < s.size(); ++pos) {
+        if (((s[pos] == Cs) || ...)) {
+            return pos;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+} // namespace util
+
+#endif
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "util/find_first_of.h"
+
+#include "etest/etest2.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+int main() {
+    etest::Suite s;
+
+    s.constexpr_test("short input", [](etest::IActions &a) {
+        a.expect_eq(util::find_first_of<'<', '&'>("hello & <goodbye>"sv), std::size_t{6});
+        a.expect_eq(util::find_first_of<'<', '&'>("hello & <goodbye>"sv, 7), std::size_t{8});
+        a.expect_eq(util::find_first_of<'<', '&'>("hello"sv), std::string_view::npos);
+        a.expect_eq(util::find_first_of<'<'>(""sv), std::string_view::npos);
+        a.expect_eq(util::find_first_of<'<'>("<"sv, 1), std::string_view::npos);
+        a.expect_eq(util::find_first_of<'<'>("<"sv, 5), std::string_view::npos);
+    });
+
+    s.constexpr_test("null", [](etest::IActions &a) {
+        a.expect_eq(util::find_first_of<'\0'>("abc\0def"sv), std::size_t{3}); //
+    });
+
+    s.add_test("long input", [](etest::IActions &a) {
+        // Check every position and offset around the 16-byte chunks against the standard library.
+        for (std::size_t size = 0; size < 70; ++size) {
+            for (std::size_t needle = 0; needle <= size; ++needle) {
+                std::string input(size, 'a');
+                if (needle < size) {
+                    input[needle] = '"';
+                }
+
+                for (std::size_t pos = 0; pos <= size; ++pos) {
+                    a.expect_eq(util::find_first_of<'"', '&', '\0'>(input, pos), input.find_first_of("\"&\0"sv, pos));
+                }
+            }
+        }
+    });
+
+    s.add_test("non-ascii", [](etest::IActions &a) {
+        auto input = "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\x80"sv;
+        a.expect_eq(util::find_first_of<'\x80'>(input), std::size_t{17});
+        a.expect_eq(util::find_first_of<'<'>(input), std::string_view::npos);
+    });
+
+    return s.run();
+}
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef UTIL_SHA256_H_
+#define UTIL_SHA256_H_
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace util {
+
+// https://datatracker.ietf.org/doc/html/rfc6234#section-6.2
+template<typename T, std::size_t U = std::dynamic_extent>
+requires(sizeof(T) == 1)
+constexpr std::array<std::uint8_t, 32> sha256(std::span<T const, U> data) {
+    constexpr auto kK = std::to_array<std::uint32_t>({
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    });
+
+    std::array<std::uint32_t, 8> h{
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    auto process_block = [&](std::array<std::uint8_t, 64> const &block) {
+        std::array<std::uint32_t, 64> w{};
+        for (std::size_t t = 0; t < 16; ++t) {
+            w[t] = static_cast<std::uint32_t>(block[t * 4]) << 24 | static_cast<std::uint32_t>(block[t * 4 + 1]) << 16
+                    | static_cast<std::uint32_t>(block[t * 4 + 2]) << 8 | static_cast<std::uint32_t>(block[t * 4 + 3]);
+        }
+
+        for (std::size_t t = 16; t < 64; ++t) {
+            auto s0 = std::rotr(w[t - 15], 7) ^ std::rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            auto s1 = std::rotr(w[t - 2], 17) ^ std::rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        auto [a, b, c, d, e, f, g, hh] = h;
+        for (std::size_t t = 0; t < 64; ++t) {
+            auto s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+            auto ch = (e & f) ^ (~e & g);
+            auto t1 = hh + s1 + ch + kK[t] + w[t];
+            auto s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+            auto maj = (a & b) ^ (a & c) ^ (b & c);
+            auto t2 = s0 + maj;
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += hh;
+    };
+
+    std::array<std::uint8_t, 64> block{};
+    std::size_t block_size = 0;
+    for (auto byte : data) {
+        block[block_size++] = static_cast<std::uint8_t>(byte);
+        if (block_size == block.size()) {
+            process_block(block);
+            block_size = 0;
+        }
+    }
+
+    // Pad with a 1-bit, zeros, and the message length in bits.
+    block[block_size++] = 0x80;
+    if (block_size > 56) {
+        while (block_size < block.size()) {
+            block[block_size++] = 0;
+        }
+
+        process_block(block);
+        block_size = 0;
+    }
+
+    while (block_size < 56) {
+        block[block_size++] = 0;
+    }
+
+    auto const bit_length = static_cast<std::uint64_t>(data.size()) * 8;
+    for (int i = 7; i >= 0; --i) {
+        block[block_size++] = static_cast<std::uint8_t>(bit_length >> (i * 8));
+    }
+
+    process_block(block);
+
+    std::array<std::uint8_t, 32> digest{};
+    for (std::size_t i = 0; i < h.size(); ++i) {
+        digest[i * 4] = static_cast<std::uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<std::uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<std::uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<std::uint8_t>(h[i]);
+    }
+
+    return digest;
+}
+
+} // namespace util
+
+#endif
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025 Robin Lindén <dev@robinlinden.eu>
+//
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "util/sha256.h"
+
+#include "etest/etest2.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace {
+constexpr std::string to_hex(std::array<std::uint8_t, 32> const &digest) {
+    constexpr auto kHexDigits = "0123456789abcdef"sv;
+    std::string hex;
+    for (auto byte : digest) {
+        hex += kHexDigits[byte >> 4];
+        hex += kHexDigits[byte & 0xf];
+    }
+    return hex;
+}
+} // namespace
+
+int main() {
+    etest::Suite s;
+    s.constexpr_test("no data", [](etest::IActions &a) {
+        a.expect_eq(to_hex(util::sha256(std::span{""sv})),
+                "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    });
+
+    s.constexpr_test("one block", [](etest::IActions &a) {
+        a.expect_eq(to_hex(util::sha256(std::span{"abc"sv})),
+                "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    });
+
+    s.add_test("padding spills into a second block", [](etest::IActions &a) {
+        auto data = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"sv;
+        a.expect_eq(to_hex(util::sha256(std::span{data})),
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    });
+
+    s.add_test("many blocks", [](etest::IActions &a) {
+        auto data = std::string(1000, 'a');
+        a.expect_eq(to_hex(util::sha256(std::span<char const>{data})),
+                "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+    });
+
+    s.add_test("bytes", [](etest::IActions &a) {
+        auto data = std::to_array({std::byte{'a'}, std::byte{'b'}, std::byte{'c'}});
+        a.expect_eq(to_hex(util::sha256(std::span<std::byte const>{data})),
+                "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    });
+
+    return s.run();
+}
@@ -13,6 +13,7 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <ios>
 #include <iterator>
 #include <span>
@@ -151,6 +152,35 @@ constexpr std::string_view trim(std::string_view s) {
     return trim(s, is_whitespace);
 }
 
+// https://infra.spec.whatwg.org/#ascii-whitespace
+constexpr bool is_ascii_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+// https://infra.spec.whatwg.org/#split-on-ascii-whitespace, but calling `f`
+// with each token instead of collecting them, as e.g. class attributes are
+// split for every element that's styled.
+template<std::invocable<std::string_view> F>
+constexpr void for_each_ascii_whitespace_split(std::string_view s, F &&f) {
+    while (true) {
+        s = trim_start(s, is_ascii_whitespace);
+        if (s.empty()) {
+            return;
+        }
+
+        auto len = static_cast<std::size_t>(std::ranges::find_if(s, is_ascii_whitespace) - s.begin());
+        f(s.substr(0, len));
+        s.remove_prefix(len);
+    }
+}
+
+// Lets unordered containers keyed on std::string be looked up with a
+// std::string_view without allocating.
+struct TransparentStringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
 constexpr std::string join(std::span<std::string_view const> strings, std::string_view separator) {
     std::string out;
 
@@ -218,6 +218,32 @@ int main() {
         a.expect(!is_whitespace('\0'));
     });
 
+    es.add_test("is ascii whitespace", [](etest::IActions &a) {
+        a.expect(is_ascii_whitespace(' '));
+        a.expect(is_ascii_whitespace('\n'));
+        a.expect(is_ascii_whitespace('\r'));
+        a.expect(is_ascii_whitespace('\f'));
+        a.expect(is_ascii_whitespace('\t'));
+
+        a.expect(!is_ascii_whitespace('\v'));
+        a.expect(!is_ascii_whitespace('a'));
+        a.expect(!is_ascii_whitespace('\0'));
+    });
+
+    es.add_test("for each ascii whitespace split", [](etest::IActions &a) {
+        auto split = [](std::string_view s) {
+            std::vector<std::string_view> tokens;
+            for_each_ascii_whitespace_split(s, [&](std::string_view token) { tokens.push_back(token); });
+            return tokens;
+        };
+
+        a.expect_eq(split(""), std::vector<std::string_view>{});
+        a.expect_eq(split(" \t\n\f\r"), std::vector<std::string_view>{});
+        a.expect_eq(split("a"), std::vector{"a"sv});
+        a.expect_eq(split("  a \tbb\n\nc "), std::vector{"a"sv, "bb"sv, "c"sv});
+        a.expect_eq(split("a\vb"), std::vector{"a\vb"sv});
+    });
+
     es.add_test("trim start", [](etest::IActions &a) {
         a.expect_eq(trim_start(" abc "sv), "abc "sv);
         a.expect_eq(trim_start("\t431\r\n"sv), "431\r\n"sv);